@@ -8,18 +8,41 @@
 #include "8259a.h"
 #include "iocc.h"
 #include "mmu.h"
+#include "romp.h"
 #include "logfac.h"
+#include "timeline.h"
 
 struct ioBusStruct* ioBusPtr;
 
-void init8259 (struct struct8259* curr8259, struct ioBusStruct* ioBusPointer, uint32_t ioaddr, uint32_t ioaddrMask) {
+void init8259 (struct struct8259* curr8259, struct ioBusStruct* ioBusPointer, uint32_t ioaddr, uint32_t ioaddrMask, uint8_t cpuIntrpt) {
 	curr8259->initreq = 4;
+	curr8259->cpuIntrpt = cpuIntrpt;
 	curr8259->edgeLatches = 0xFF;
 	curr8259->ioAddress = ioaddr;
 	curr8259->ioAddressMask = ioaddrMask;
 	ioBusPtr = ioBusPointer;
 }
 
+// Only called when an input line, the IMR, the ISR or a command changes.
+// Pushes INT output changes straight into the processor's interrupt lines.
+void update8259 (struct struct8259* curr8259) {
+	// If IRR isn't frozen, set only if edgeLatch is set (ie hasn't been polled and reset to zero)
+	if (!curr8259->freezeIRR) {
+		curr8259->irr = curr8259->edgeLatches & curr8259->intLines;
+	}
+
+	if (curr8259->irr & ~curr8259->ocw1) {
+		// If any pass our mask, trigger the int pin.
+		curr8259->intreq = 1;
+	}
+
+	if (curr8259->intreq != curr8259->intOut) {
+		curr8259->intOut = curr8259->intreq;
+		logmsgf(LOG8259, "8259: INT %s IRR:0x%02X ISR:0x%02X IMR:0x%02X\n", curr8259->intOut ? "raised" : "lowered", curr8259->irr, curr8259->isr, curr8259->ocw1);
+		setIntrptLine(curr8259->cpuIntrpt, curr8259->intOut);
+	}
+}
+
 void write8259 (struct struct8259* curr8259) {
 	uint8_t data = (ioBusPtr->data & 0x00FF);
 	if (curr8259->initreq) {
@@ -75,14 +98,8 @@ void write8259 (struct struct8259* curr8259) {
 				curr8259->freezeIRR = 0;
 				curr8259->irr = 0;
 				curr8259->intreq = 0;
-				if (curr8259->isr & 0x01) {curr8259->isr &= ~0x01; return;}
-				if (curr8259->isr & 0x02) {curr8259->isr &= ~0x02; return;}
-				if (curr8259->isr & 0x04) {curr8259->isr &= ~0x04; return;}
-				if (curr8259->isr & 0x08) {curr8259->isr &= ~0x08; return;}
-				if (curr8259->isr & 0x10) {curr8259->isr &= ~0x10; return;}
-				if (curr8259->isr & 0x20) {curr8259->isr &= ~0x20; return;}
-				if (curr8259->isr & 0x40) {curr8259->isr &= ~0x40; return;}
-				if (curr8259->isr & 0x80) {curr8259->isr &= ~0x80; return;}
+				// Lowest set bit is the highest priority in service
+				curr8259->isr &= curr8259->isr - 1;
 			} else if ((ioBusPtr->data & OCW2_CMD) == OCW2_CMD_SpecEOI) {
 				logmsgf(LOG8259, "8259: OCW2 Specific EOI reset ISR: 0x%02X\n", (~(0x01 << (ioBusPtr->data & OCW2_Level)) & 0xFF));
 				curr8259->freezeIRR = 0;
@@ -160,31 +177,18 @@ void access8259 (struct struct8259* curr8259) {
 			} else {
 				read8259(curr8259);
 			}
+			update8259(curr8259);
 			ioBusPtr->cs16 = 0;
 		}
 	}
 }
 
-void cycle8259 (struct struct8259* curr8259) {
-	//if (!curr8259->reset) {curr8259->initreq = 4; return;}
-
-	// If IRR isn't frozen, set only if edgeLatch is set (ie hasn't been polled and reset to zero)
-	if (!curr8259->freezeIRR) {
-		curr8259->irr = curr8259->edgeLatches & curr8259->intLines;
-	}
-
-	// Rising edge
-	//if (curr8259->intLines & ~curr8259->prevIntLines) {
-	if (curr8259->irr & ~curr8259->ocw1) {
-		// If any pass our mask, trigger the int pin.
-		curr8259->intreq = 1;
-		//logmsgf(LOG8259, "8259: Interrupts received 0x%02X\n", curr8259->irr);
-	}
-	//}
-
+void set8259Lines (struct struct8259* curr8259, uint8_t lines) {
+	if (lines == curr8259->intLines) {return;}
+	logmsgf(LOG8259, "8259: IR lines 0x%02X -> 0x%02X\n", curr8259->intLines, lines);
 	// Edge latches only get enabled on a falling edge
-	if (~curr8259->intLines & curr8259->prevIntLines) {
-		curr8259->edgeLatches |= ~curr8259->intLines & curr8259->prevIntLines;
-	}
-	curr8259->prevIntLines = curr8259->intLines;
-}
\ No newline at end of file
+	curr8259->edgeLatches |= ~lines & curr8259->intLines;
+	curr8259->intLines = lines;
+	if (timelineOn) {timelineAdd(TL_IRLINES, curr8259->cpuIntrpt, lines, 0);}
+	update8259(curr8259);
+}
@@ -16,12 +16,13 @@ struct struct8259 {
 	uint8_t ocw1;
 	uint8_t ocw3;
 	uint8_t intLines;
-	uint8_t prevIntLines;
 	uint8_t edgeLatches;
 	uint8_t freezeIRR;
 	uint8_t irr;
 	uint8_t isr;
 	uint8_t intreq;
+	uint8_t intOut;		// Last INT output level pushed to the processor
+	uint8_t cpuIntrpt;	// Processor interrupt line (INTRPT_x) driven by INT
 };
 
 #define ICW1_InterruptVectAddr	0xE0
@@ -39,8 +40,8 @@ struct struct8259 {
 #define OCW3_PollingCmd				0x04
 #define OCW3_ReadRegCmd				0x03
 
-void init8259 (struct struct8259* curr8259, struct ioBusStruct* ioBusPointer, uint32_t ioaddr, uint32_t ioaddrMask);
+void init8259 (struct struct8259* curr8259, struct ioBusStruct* ioBusPointer, uint32_t ioaddr, uint32_t ioaddrMask, uint8_t cpuIntrpt);
 void access8259 (struct struct8259* curr8259);
-void cycle8259 (struct struct8259* curr8259);
+void set8259Lines (struct struct8259* curr8259, uint8_t lines);
 
 #endif
\ No newline at end of file
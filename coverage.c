@@ -0,0 +1,171 @@
+// Guest Code Coverage
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "coverage.h"
+#include "romp.h"
+#include "mmu.h"
+#include "memory.h"
+#include "symbols.h"
+
+#define COVPAGE	2048	// Smallest translation page, runs are located a page at a time
+
+int coverageOn = 0;
+uint32_t covNext = 0;
+uint32_t covLastInst = 0;
+
+char covFile[256];
+uint32_t covStart;
+uint8_t covVirt;
+uint32_t covLastStart = 1, covLastEnd = 1;	// Last real mode run, loops mark the same one over and over
+uint8_t *covROM = NULL;		// ROMSIZE / 16 bytes
+uint8_t *covRAM = NULL;		// MEMORYSIZE / 16 bytes
+int covUnmapped = 0;		// Something ran from neither
+
+int coverageStart (const char *file) {
+	covROM = calloc(ROMSIZE / 16, 1);
+	covRAM = calloc(MEMORYSIZE / 16, 1);
+	if (!covROM || !covRAM) {
+		printf("Error allocating coverage bitmaps\n");
+		return -1;
+	}
+	snprintf(covFile, sizeof(covFile), "%s", file);
+	covStart = getSCRptr()->IAR;
+	covVirt = (getSCRptr()->ICS & ICS_MASK_TranslateMode) != 0;
+	covNext = covStart;
+	covLastInst = 0;
+	coverageOn = 1;
+	return 0;
+}
+
+void markBits (uint8_t* bitmap, uint32_t offset, uint32_t len) {
+	for (uint32_t half = offset >> 1; half < (offset + len + 1) >> 1; half++) {
+		bitmap[half >> 3] |= 1 << (half & 7);
+	}
+}
+
+// Marks len bytes of code at addr, a page at a time through the MMU if need be
+void markRun (uint32_t addr, uint32_t len, int virt) {
+	while (len) {
+		uint32_t chunk = COVPAGE - (addr & (COVPAGE - 1));
+		if (chunk > len) {chunk = len;}
+		uint32_t real = addr;
+		uint32_t offset;
+		int space = MEMSPACE_NONE;
+		if (!virt || !debugTranslate(addr, &real)) {
+			space = debugLocate(real, &offset);
+		}
+		if (space == MEMSPACE_ROM && offset + chunk <= ROMSIZE) {
+			markBits(covROM, offset, chunk);
+		} else if (space == MEMSPACE_RAM && offset + chunk <= MEMORYSIZE) {
+			markBits(covRAM, offset, chunk);
+		} else {
+			covUnmapped = 1;
+		}
+		addr += chunk;
+		len -= chunk;
+	}
+}
+
+void coverageJump (uint32_t iar) {
+	uint32_t end = covNext;
+	// A taken execute branch ran its subject too, mark its first halfword
+	uint8_t op = covLastInst >> 24;
+	if (op == 0x89 || op == 0x8B || op == 0x8D || op == 0x8F || op == 0xE9 || op == 0xED || op == 0xEF) {
+		end += 2;
+	}
+	if (covVirt) {
+		// Mappings can change under the same virtual run, always translate
+		if (end > covStart) {markRun(covStart, end - covStart, 1);}
+		covLastEnd = 1;
+	} else if (end > covStart && (covStart != covLastStart || end != covLastEnd)) {
+		markRun(covStart, end - covStart, 0);
+		covLastStart = covStart;
+		covLastEnd = end;
+	}
+	covStart = iar;
+	covVirt = (getSCRptr()->ICS & ICS_MASK_TranslateMode) != 0;
+}
+
+int covHit (uint8_t* bitmap, uint32_t offset) {
+	return (bitmap[offset >> 4] >> ((offset >> 1) & 7)) & 1;
+}
+
+void writeROM (FILE* out) {
+	uint32_t base = debugROMBase();
+	uint8_t rom[ROMSIZE];
+	debugRealRead(base, rom, ROMSIZE);
+	uint32_t hit = 0;
+	for (uint32_t offset=0; offset < ROMSIZE; offset += 2) {
+		hit += covHit(covROM, offset);
+	}
+	fprintf(out, "# ROM at 0x%08X: %u of %u halfwords executed (%.1f%%)\n", base, hit, ROMSIZE / 2, (hit * 100.0) / (ROMSIZE / 2));
+	if (covUnmapped) {
+		fprintf(out, "# Code also ran outside ROM and RAM, untracked\n");
+	}
+	fprintf(out, "\n");
+
+	char text[DISASMMAX];
+	uint32_t offset = 0;
+	while (offset < ROMSIZE) {
+		uint32_t addr = base + offset;
+		const char *label = symLabel(addr);
+		if (label) {
+			fprintf(out, "%s:\n", label);
+		}
+		uint32_t inst = (rom[offset] << 24) | (rom[(offset + 1) & 0xFFFF] << 16) | (rom[(offset + 2) & 0xFFFF] << 8) | rom[(offset + 3) & 0xFFFF];
+		int len = instLength(inst);
+		int executed = covHit(covROM, offset);
+		// Not executed and overlapping code that was, resync on the executed halfword
+		if (!executed && len == 4 && covHit(covROM, (offset + 2) & 0xFFFF)) {
+			fprintf(out, "- 0x%08X: 0x%04X\t\t.short\n", addr, inst >> 16);
+			offset += 2;
+			continue;
+		}
+		disasm(inst, text, sizeof(text));
+		if (len == 4) {
+			fprintf(out, "%c 0x%08X: 0x%08X\t%s\n", executed ? '+' : '-', addr, inst, text);
+		} else {
+			fprintf(out, "%c 0x%08X: 0x%04X\t\t%s\n", executed ? '+' : '-', addr, inst >> 16, text);
+		}
+		offset += len;
+	}
+}
+
+void writeRAM (FILE* out) {
+	uint64_t hit = 0;
+	fprintf(out, "\n# Executed RAM (offsets into RAM)\n");
+	uint32_t offset = 0;
+	while (offset < MEMORYSIZE) {
+		if (!covRAM[offset >> 4] && !(offset & 15)) {
+			offset += 16;
+			continue;
+		}
+		if (!covHit(covRAM, offset)) {
+			offset += 2;
+			continue;
+		}
+		uint32_t start = offset;
+		while (offset < MEMORYSIZE && covHit(covRAM, offset)) {offset += 2;}
+		fprintf(out, "0x%06X-0x%06X %u halfwords\n", start, offset - 2, (offset - start) >> 1);
+		hit += (offset - start) >> 1;
+	}
+	fprintf(out, "# %llu halfwords of RAM executed\n", (unsigned long long)hit);
+}
+
+void coverageStop (void) {
+	if (!coverageOn) {return;}
+	coverageOn = 0;
+	coverageJump(covNext);
+	FILE *out = fopen(covFile, "w");
+	if (!out) {
+		printf("Error opening %s\n", covFile);
+	} else {
+		writeROM(out);
+		writeRAM(out);
+		fclose(out);
+	}
+	free(covROM);
+	free(covRAM);
+}
@@ -0,0 +1,27 @@
+// Guest Code Coverage
+#ifndef _COVERAGE
+#define _COVERAGE
+#include <stdint.h>
+#include "disasm.h"
+
+// One bit per halfword of ROM and RAM, set for every executed instruction.
+// Like the profiler, runs of sequential IAR are marked when they end rather
+// than per instruction. At exit the file gets the ROM as an annotated
+// disassembly ('+' executed, '-' not) and the executed ranges of RAM.
+
+extern int coverageOn;
+extern uint32_t covNext;
+extern uint32_t covLastInst;
+
+int coverageStart (const char *file);
+void coverageJump (uint32_t iar);
+void coverageStop (void);
+
+// Called from fetch() before each instruction is decoded
+static inline void coverageStep (uint32_t iar, uint32_t inst) {
+	if (iar != covNext) {coverageJump(iar);}
+	covLastInst = inst;
+	covNext = iar + instLength(inst);
+}
+
+#endif
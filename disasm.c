@@ -0,0 +1,281 @@
+// ROMP Disassembler
+#include <stdio.h>
+#include <stdint.h>
+
+#include "disasm.h"
+
+const char* getCSname (unsigned int CSnum) {
+	switch (CSnum) {
+		case 0x8:
+			return "0";
+		case 0x9:
+			return "LT";
+		case 0xA:
+			return "EQ";
+		case 0xB:
+			return "GT";
+		case 0xC:
+			return "C0";
+		case 0xE:
+			return "OV";
+		case 0xF:
+			return "TB";
+		default:
+			return "RESV";
+	}
+}
+
+const char* gpr_or_0 (unsigned int r3) {
+	switch (r3) {
+		case 0x0:
+			return "0";
+		case 0x1:
+			return "GPR1";
+		case 0x2:
+			return "GPR2";
+		case 0x3:
+			return "GPR3";
+		case 0x4:
+			return "GPR4";
+		case 0x5:
+			return "GPR5";
+		case 0x6:
+			return "GPR6";
+		case 0x7:
+			return "GPR7";
+		case 0x8:
+			return "GPR8";
+		case 0x9:
+			return "GPR9";
+		case 0xA:
+			return "GPR10";
+		case 0xB:
+			return "GPR11";
+		case 0xC:
+			return "GPR12";
+		case 0xD:
+			return "GPR13";
+		case 0xE:
+			return "GPR14";
+		case 0xF:
+			return "GPR15";
+		default:
+			return "ERR";
+	}
+}
+
+// JI and D-Short formats, indexed by the first nibble
+static const struct disasmEntry shortFormats[8] = {
+	{"J%s %s,%d", OPS_JI, 0},
+	{"STCS %s+%d,GPR%d", OPS_DS_STORE, 0},
+	{"STHS %s+%d,GPR%d", OPS_DS_STORE, 1},
+	{"STS %s+%d,GPR%d", OPS_DS_STORE, 2},
+	{"LCS GPR%d, %s+%d", OPS_DS_LOAD, 0},
+	{"LHAS GPR%d, %s+%d", OPS_DS_LOAD, 1},
+	{"CAS GPR%d, GPR%d+%s", OPS_CAS, 0},
+	{"LS GPR%d, %s+%d", OPS_DS_LOAD, 2},
+};
+
+// Everything else, indexed by the first byte
+static const struct disasmEntry longFormats[256] = {
+	[0x88] = {"BNB %s,%d", OPS_CS_BI, 0},
+	[0x89] = {"BNBX %s,%d", OPS_CS_BI, 0},
+	[0x8A] = {"BALA 0x%06X", OPS_BA, 0},
+	[0x8B] = {"BALAX 0x%06X", OPS_BA, 0},
+	[0x8C] = {"BALI GPR%d, %d", OPS_R_BI, 0},
+	[0x8D] = {"BALIX GPR%d, %d", OPS_R_BI, 0},
+	[0x8E] = {"BB %s,%d", OPS_CS_BI, 0},
+	[0x8F] = {"BBX %s,%d", OPS_CS_BI, 0},
+	[0x90] = {"AIS GPR%d, %d", OPS_R2_R3, 0},
+	[0x91] = {"INC GPR%d, GPR%d+%02X", OPS_R2_R2_R3, 0},
+	[0x92] = {"SIS GPR%d, %d", OPS_R2_R3, 0},
+	[0x93] = {"DEC GPR%d, GPR%d-%02X", OPS_R2_R2_R3, 0},
+	[0x94] = {"CIS GPR%d, %d", OPS_R2_R3, 0},
+	[0x95] = {"CLRSB SCR%d, %d", OPS_R2_R3, 0},
+	[0x96] = {"MFS SCR%d, GPR%d", OPS_R2_R3, 0},
+	[0x97] = {"SETSB SCR%d, %d", OPS_R2_R3, 0},
+	[0x98] = {"CLRBU GPR%d, %d", OPS_R2_R3, 0},
+	[0x99] = {"CLRBL GPR%d, %d", OPS_R2_R3, 0},
+	[0x9A] = {"SETBU GPR%d, %d", OPS_R2_R3, 0},
+	[0x9B] = {"SETBL GPR%d, %d", OPS_R2_R3, 0},
+	[0x9C] = {"MFTBIU GPR%d, %d", OPS_R2_R3, 0},
+	[0x9D] = {"MFTBIL GPR%d, %d", OPS_R2_R3, 0},
+	[0x9E] = {"MTTBIU GPR%d, %d", OPS_R2_R3, 0},
+	[0x9F] = {"MTTBIL GPR%d, %d", OPS_R2_R3, 0},
+	[0xA0] = {"SARI GPR%d, %d", OPS_R2_R3, 0},
+	[0xA1] = {"SARI16 GPR%d, %d+16", OPS_R2_R3, 0},
+	[0xA4] = {"LIS GPR%d, 0x%02X", OPS_R2_R3, 0},
+	[0xA8] = {"SRI GPR%d, %d", OPS_R2_R3, 0},
+	[0xA9] = {"SRI16 GPR%d, %d+16", OPS_R2_R3, 0},
+	[0xAA] = {"SLI GPR%d, %d", OPS_R2_R3, 0},
+	[0xAB] = {"SLI16 GPR%d, %d+16", OPS_R2_R3, 0},
+	[0xAC] = {"SRPI GPR%d, %d", OPS_R2_R3, 0},
+	[0xAD] = {"SRPI16 GPR%d, %d+16", OPS_R2_R3, 0},
+	[0xAE] = {"SLPI GPR%d, %d", OPS_R2_R3, 0},
+	[0xAF] = {"SLPI16 GPR%d, %d+16", OPS_R2_R3, 0},
+	[0xB0] = {"SAR GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB1] = {"EXTS GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB2] = {"SF GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB3] = {"CL GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB4] = {"C GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB5] = {"MTS SCR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB6] = {"D GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB8] = {"SR GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xB9] = {"SRP GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xBA] = {"SL GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xBB] = {"SLP GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xBC] = {"MFTB GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xBD] = {"TGTE GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xBE] = {"TLT GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xBF] = {"MTTB GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xC0] = {"SVC %s+%d", OPS_B_SI, 0},
+	[0xC1] = {"AI GPR%d, GPR%d+%d", OPS_R_R_SI, 0},
+	[0xC2] = {"CAL16 GPR%d, %s+%04X", OPS_R_B_I16, 0},
+	[0xC3] = {"OIU GPR%d, GPR%d | 0x%04X", OPS_R_R_I16, 0},
+	[0xC4] = {"OIL GPR%d, GPR%d | 0x%04X", OPS_R_R_I16, 0},
+	[0xC5] = {"NILZ GPR%d, GPR%d & 0x%04X", OPS_R_R_I16, 0},
+	[0xC6] = {"NILO GPR%d, GPR%d & 0x%04X", OPS_R_R_I16, 0},
+	[0xC7] = {"XIL GPR%d, GPR%d ^ 0x%04X", OPS_R_R_I16, 0},
+	[0xC8] = {"CAL GPR%d, %s+%d", OPS_R_B_SI, 0},
+	[0xC9] = {"LM GPR%d, %s+%d", OPS_R_B_SI, 0},
+	[0xCA] = {"LHA GPR%d, %s+%d", OPS_R_B_SI, 1},
+	[0xCB] = {"IOR GPR%d, %s+0x%04X", OPS_R_B_I16, 0},
+	[0xCC] = {"TI GPR%d, 0x%08X", OPS_R3_SI, 0},
+	[0xCD] = {"L GPR%d, %s+%d", OPS_R_B_SI, 0},
+	[0xCE] = {"LC GPR%d, %s+%d", OPS_R_B_SI, 0},
+	[0xCF] = {"TSH GPR%d, %s+%d", OPS_R_B_SI, 1},
+	[0xD0] = {"LPS 0x%X, %s+%d", OPS_R_B_SI, 0},
+	[0xD1] = {"AEI GPR%d, GPR%d+%d", OPS_R_R_SI, 0},
+	[0xD2] = {"AFI GPR%d, GPR%d+%d", OPS_R_R_SI, 0},
+	[0xD3] = {"CLI GPR%d, %d", OPS_R3_SI, 0},
+	[0xD4] = {"CI GPR%d, %d", OPS_R3_SI, 0},
+	[0xD5] = {"NIUZ GPR%d, GPR%d & 0x%04X", OPS_R_R_I16, 0},
+	[0xD6] = {"NIUO GPR%d, GPR%d & 0x%04X", OPS_R_R_I16, 0},
+	[0xD7] = {"XIU GPR%d, GPR%d & 0x%04X", OPS_R_R_I16, 0},
+	[0xD8] = {"CAU GPR%d, %s+0x%04X", OPS_R_B_I16, 0},
+	[0xD9] = {"STM %s+%d,GPR%d", OPS_B_SI_R, 0},
+	[0xDA] = {"LH GPR%d, %s+%d", OPS_R_B_SI, 0},
+	[0xDB] = {"IOW %s+0x%04X, GPR%d", OPS_B_I16_R, 0},
+	[0xDC] = {"STH %s+%d,GPR%d", OPS_B_SI_R, 0},
+	[0xDD] = {"ST %s+%d,GPR%d", OPS_B_SI_R, 0},
+	[0xDE] = {"STC %s+%d,GPR%d", OPS_B_SI_R, 0},
+	[0xE0] = {"ABS GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xE1] = {"A GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xE2] = {"S GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xE3] = {"O GPR%d, GPR%d | GPR%d", OPS_R2_R2_R3, 0},
+	[0xE4] = {"TWOC GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xE5] = {"N GPR%d, GPR%d & GPR%d", OPS_R2_R2_R3, 0},
+	[0xE6] = {"M GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xE7] = {"X GPR%d, GPR%d ^ GPR%d", OPS_R2_R2_R3, 0},
+	[0xE8] = {"BNBR %s,GPR%d", OPS_CS_R, 0},
+	[0xE9] = {"BNBRX %s,GPR%d", OPS_CS_R, 0},
+	[0xEB] = {"LHS GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xEC] = {"BALR GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xED] = {"BALRX GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xEE] = {"BBR %s,GPR%d", OPS_CS_R, 0},
+	[0xEF] = {"BBRX %s,GPR%d", OPS_CS_R, 0},
+	[0xF0] = {"WAIT", OPS_NONE, 0},
+	[0xF1] = {"AE GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xF2] = {"SE GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xF3] = {"CA16 GPR%d, GPR%d+GPR%d", OPS_R2_R2_R3, 0},
+	[0xF4] = {"ONEC GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xF5] = {"CLZ GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xF9] = {"MC03 GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xFA] = {"MC13 GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xFB] = {"MC23 GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xFC] = {"MC33 GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xFD] = {"MC30 GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xFE] = {"MC31 GPR%d, GPR%d", OPS_R2_R3, 0},
+	[0xFF] = {"MC32 GPR%d, GPR%d", OPS_R2_R3, 0},
+};
+
+const struct disasmEntry* disasmLookup (uint32_t inst) {
+	uint8_t nibble0 = (inst & 0xF0000000) >> 28;
+	return (nibble0 < 8) ? &shortFormats[nibble0] : &longFormats[(inst & 0xFF000000) >> 24];
+}
+
+// Not an illegal opcode
+int disasmLegal (uint32_t inst) {
+	return disasmLookup(inst)->fmt != NULL;
+}
+
+// BI, BA and D format instructions are a word, everything else a halfword.
+// Writes the mnemonic and operands for inst (left justified in a word) to buf.
+// Returns the instruction length in bytes.
+int disasm (uint32_t inst, char *buf, int size) {
+	uint8_t r1 = (inst & 0x0F000000) >> 24;
+	uint8_t r2 = (inst & 0x00F00000) >> 20;
+	uint8_t r3 = (inst & 0x000F0000) >> 16;
+	uint8_t byte0 = (inst & 0xFF000000) >> 24;
+	uint32_t BA = (inst & 0x00FFFFFE);
+	uint16_t I16 = inst & 0x0000FFFF;
+	int32_t JI = inst & 0x00800000 ? (((inst & 0x007F0000) >> 15) | 0xFFFFFF00) : (inst & 0x007F0000) >> 15;
+	int32_t sI16 = inst & 0x00008000 ? inst | 0xFFFF0000 : inst & 0x00007FFF;
+	const struct disasmEntry *entry = disasmLookup(inst);
+
+	if (entry->fmt == NULL) {
+		snprintf(buf, size, "DC 0x%02X", byte0);
+		return instLength(inst);
+	}
+
+	switch (entry->ops) {
+		case OPS_NONE:
+			snprintf(buf, size, "%s", entry->fmt);
+			break;
+		case OPS_JI:
+			snprintf(buf, size, entry->fmt, (inst & 0x08000000) ? "B" : "NB", getCSname((r1 & 0x7)+8), JI);
+			break;
+		case OPS_DS_STORE:
+			snprintf(buf, size, entry->fmt, gpr_or_0(r3), r1 << entry->shift, r2);
+			break;
+		case OPS_DS_LOAD:
+			snprintf(buf, size, entry->fmt, r2, gpr_or_0(r3), r1 << entry->shift);
+			break;
+		case OPS_CAS:
+			snprintf(buf, size, entry->fmt, r1, r2, gpr_or_0(r3));
+			break;
+		case OPS_CS_BI:
+			snprintf(buf, size, entry->fmt, getCSname(r2), sI16 << 1);
+			break;
+		case OPS_BA:
+			snprintf(buf, size, entry->fmt, BA);
+			break;
+		case OPS_R_BI:
+			snprintf(buf, size, entry->fmt, r2, sI16 << 1);
+			break;
+		case OPS_R2_R3:
+			snprintf(buf, size, entry->fmt, r2, r3);
+			break;
+		case OPS_R2_R2_R3:
+			snprintf(buf, size, entry->fmt, r2, r2, r3);
+			break;
+		case OPS_B_SI:
+			snprintf(buf, size, entry->fmt, gpr_or_0(r3), sI16);
+			break;
+		case OPS_R_R_SI:
+			snprintf(buf, size, entry->fmt, r2, r3, sI16);
+			break;
+		case OPS_R_B_I16:
+			snprintf(buf, size, entry->fmt, r2, gpr_or_0(r3), I16);
+			break;
+		case OPS_R_R_I16:
+			snprintf(buf, size, entry->fmt, r2, r3, I16);
+			break;
+		case OPS_R_B_SI:
+			snprintf(buf, size, entry->fmt, r2, gpr_or_0(r3), sI16 << entry->shift);
+			break;
+		case OPS_R3_SI:
+			snprintf(buf, size, entry->fmt, r3, sI16);
+			break;
+		case OPS_B_SI_R:
+			snprintf(buf, size, entry->fmt, gpr_or_0(r3), sI16, r2);
+			break;
+		case OPS_B_I16_R:
+			snprintf(buf, size, entry->fmt, gpr_or_0(r3), I16, r2);
+			break;
+		case OPS_CS_R:
+			snprintf(buf, size, entry->fmt, getCSname(r2), r3);
+			break;
+	}
+	return instLength(inst);
+}
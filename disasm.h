@@ -0,0 +1,51 @@
+// ROMP Disassembler
+#ifndef _DISASM
+#define _DISASM
+#include <stdint.h>
+
+#define DISASMMAX 48	// Longest line disasm() produces, including the terminator
+
+// Operand lists, matching the arguments decode() logs for each format
+#define OPS_NONE			0
+#define OPS_JI				1		// cs, JI
+#define OPS_DS_STORE	2		// base, r1 << shift, r2
+#define OPS_DS_LOAD		3		// r2, base, r1 << shift
+#define OPS_CAS				4		// r1, r2, base
+#define OPS_CS_BI			5		// cs, sI16 << 1
+#define OPS_BA				6		// BA
+#define OPS_R_BI			7		// r2, sI16 << 1
+#define OPS_R2_R3			8		// r2, r3
+#define OPS_R2_R2_R3	9		// r2, r2, r3
+#define OPS_B_SI			10	// base, sI16
+#define OPS_R_R_SI		11	// r2, r3, sI16
+#define OPS_R_B_I16		12	// r2, base, I16
+#define OPS_R_R_I16		13	// r2, r3, I16
+#define OPS_R_B_SI		14	// r2, base, sI16 << shift
+#define OPS_R3_SI			15	// r3, sI16
+#define OPS_B_SI_R		16	// base, sI16, r2
+#define OPS_B_I16_R		17	// base, I16, r2
+#define OPS_CS_R			18	// cs, r3
+
+struct disasmEntry {
+	const char *fmt;	// NULL if illegal
+	uint8_t ops;
+	uint8_t shift;
+};
+
+// Inline, the trace and profiler take it once per executed instruction
+static inline int instLength (uint32_t inst) {
+	uint8_t byte0 = (inst & 0xFF000000) >> 24;
+	if ((byte0 >= 0x88 && byte0 <= 0x8F) || (byte0 >= 0xC0 && byte0 <= 0xDF)) {
+		return 4;
+	}
+	return 2;
+}
+
+// Human readable condition and register names
+const char* getCSname (unsigned int CSnum);
+const char* gpr_or_0 (unsigned int r3);
+
+int disasm (uint32_t inst, char *buf, int size);
+int disasmLegal (uint32_t inst);
+
+#endif
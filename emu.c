@@ -0,0 +1,309 @@
+// Emulation Thread
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include "emu.h"
+#include "logfac.h"
+#include "memory.h"
+#include "iocc.h"
+#include "mmu.h"
+#include "ringbuf.h"
+#include "events.h"
+#include "perf.h"
+#include "screenrec.h"
+#include "shmexport.h"
+#include "triggers.h"
+#include "flightrec.h"
+#include "hostprof.h"
+
+uint8_t *emuMemptr;
+uint32_t *emuGPRptr;
+union SCRs *emuSCRptr;
+struct structmda *emuMDAptr;
+uint8_t *emuDispCodeptr;
+
+pthread_t emuThread;
+struct ringbuf cmdQueue;	// GUI thread produces, emulation thread consumes
+uint8_t cmdQueueBuf[EMUCMDMAX * sizeof(struct emuCmd)];
+struct emuSeqlock snapLock;
+atomic_int snapRequest;
+// Idle emulation thread sleeps here until a command or host key arrives
+pthread_mutex_t wakeLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t wakeCond = PTHREAD_COND_INITIALIZER;
+int wakePending = 0;
+
+int halt = 0;
+int quit = 0;
+volatile sig_atomic_t emuQuitSignal = 0;
+uint32_t breakPoint = 0;
+uint32_t memAddr = 0;
+uint8_t memVirt = 0;
+
+void emuinit (uint8_t* memptr, uint32_t* GPRptr, union SCRs* SCRptr, struct structmda* mdaptr, uint8_t* dispCodeptr) {
+	emuMemptr = memptr;
+	emuGPRptr = GPRptr;
+	emuSCRptr = SCRptr;
+	emuMDAptr = mdaptr;
+	emuDispCodeptr = dispCodeptr;
+	ringbufInit(&cmdQueue, cmdQueueBuf, sizeof(cmdQueueBuf));
+	atomic_store(&snapLock.seq, 0);
+	atomic_store(&snapRequest, 1);
+}
+
+void publishSnapshot (void) {
+	struct emuSnapshot *snap = &snapLock.snap;
+	uint32_t seq = atomic_load_explicit(&snapLock.seq, memory_order_relaxed);
+	atomic_store_explicit(&snapLock.seq, seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	memcpy(snap->GPR, emuGPRptr, sizeof(snap->GPR));
+	snap->SCR = *emuSCRptr;
+	// One bulk read of the visible range, same cost wherever it is
+	snap->memAddr = memAddr;
+	snap->memVirt = memVirt;
+	if (memVirt) {
+		debugVirtRead(memAddr, snap->memBytes, MEMPANEBYTES);
+	} else {
+		debugRealRead(memAddr, snap->memBytes, MEMPANEBYTES);
+	}
+	// Code around IAR, through the MMU if that's how it's being fetched
+	snap->disAddr = emuSCRptr->IAR - DISPANEBACK;
+	if (emuSCRptr->ICS & ICS_MASK_TranslateMode) {
+		debugVirtRead(snap->disAddr, snap->disBytes, DISPANEBYTES);
+	} else {
+		debugRealRead(snap->disAddr, snap->disBytes, DISPANEBYTES);
+	}
+	snap->dispCode = *emuDispCodeptr;
+	snap->instCount = getInstCount();
+	snap->emuTime = getEmuTime();
+	memcpy(snap->instCounter, getInstCounters(), sizeof(snap->instCounter));
+	getTLBStats(&snap->tlbHits, &snap->tlbMisses);
+	snap->halted = halt;
+	snap->mda = *emuMDAptr;
+
+	atomic_store_explicit(&snapLock.seq, seq + 2, memory_order_release);
+}
+
+void emuReadSnapshot (struct emuSnapshot* snap) {
+	uint32_t seq1, seq2;
+	do {
+		seq1 = atomic_load_explicit(&snapLock.seq, memory_order_acquire);
+		if (seq1 & 1) {continue;}
+		memcpy(snap, &snapLock.snap, sizeof(struct emuSnapshot));
+		atomic_thread_fence(memory_order_acquire);
+		seq2 = atomic_load_explicit(&snapLock.seq, memory_order_relaxed);
+	} while ((seq1 & 1) || seq1 != seq2);
+}
+
+// Wakes the emulation thread too, so it answers while halted or in WAIT
+void emuRequestSnapshot (void) {
+	atomic_store_explicit(&snapRequest, 1, memory_order_relaxed);
+	emuWake();
+}
+
+int emuSendCmd (uint32_t cmd, uint32_t arg) {
+	struct emuCmd entry = {cmd, arg};
+	if (ringbufWrite(&cmdQueue, &entry, sizeof(entry))) {return -1;}
+	emuWake();
+	return 0;
+}
+
+void emuWake (void) {
+	pthread_mutex_lock(&wakeLock);
+	wakePending = 1;
+	pthread_cond_signal(&wakeCond);
+	pthread_mutex_unlock(&wakeLock);
+}
+
+// Sleep until woken or ns of host time pass, 0 sleeps until woken.
+// Returns 1 if woken, 0 if the time ran out.
+int emuSleep (uint64_t ns) {
+	uint8_t prev = perfEnter(PERF_IDLE);
+	struct timespec until;
+	if (ns) {
+		clock_gettime(CLOCK_REALTIME, &until);
+		until.tv_sec += ns / 1000000000;
+		until.tv_nsec += ns % 1000000000;
+		if (until.tv_nsec >= 1000000000) {
+			until.tv_sec++;
+			until.tv_nsec -= 1000000000;
+		}
+	}
+	pthread_mutex_lock(&wakeLock);
+	int timedOut = 0;
+	while (!wakePending && !timedOut) {
+		if (ns) {
+			timedOut = (pthread_cond_timedwait(&wakeCond, &wakeLock, &until) == ETIMEDOUT);
+		} else {
+			pthread_cond_wait(&wakeCond, &wakeLock);
+		}
+	}
+	int woken = wakePending;
+	wakePending = 0;
+	pthread_mutex_unlock(&wakeLock);
+	perfLeave(prev);
+	return woken;
+}
+
+uint64_t hostTime (void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+// CPU is in WAIT so only a device event can change anything. Skip emulated
+// time straight to the next one, taking as long in host time if pace is set.
+// A wake ends the wait short of the event. Returns -1 if nothing is scheduled.
+int emuWaitIdle (int pace) {
+	uint64_t next = nextEventTime();
+	if (next == EVENT_NEVER) {
+		if (pace) {emuSleep(0);}
+		return -1;
+	}
+	if (pace) {
+		uint64_t wait = next - getEmuTime();
+		uint64_t start = hostTime();
+		if (emuSleep(wait)) {
+			// Woken early for a command, snapshot or key. Emulated time only
+			// moves as far as host time did, emuRun() comes back to the wait.
+			uint64_t slept = hostTime() - start;
+			if (slept + NS_PER_INST < wait) {
+				advanceEmuTime(slept);
+				return 0;
+			}
+		}
+	}
+	// iocycle() advances the last instruction time and dispatches the event
+	if (next > (getEmuTime() + NS_PER_INST)) {
+		advanceEmuTime(next - getEmuTime() - NS_PER_INST);
+	}
+	emuStep();
+	return 0;
+}
+
+void emuStep (void) {
+	// Log triggers, see triggers.h. 0x00806724: Before KBADPT init.
+	triggerPoll(emuSCRptr->IAR);
+	fetch();
+	uint8_t prev = perfEnter(PERF_IO);
+	HPROF_ENTER(HPROF_IOCYCLE);
+	iocycle();
+	HPROF_LEAVE(HPROF_IOCYCLE);
+	perfLeave(prev);
+	screenrecPoll();
+	shmexportPoll();
+}
+
+void stop (void) {
+	halt = 1;
+	shmexportSetHalted(1);
+	printInstCounter();
+	dumpMemory(emuMemptr);
+}
+
+void processCmds (void) {
+	struct emuCmd entry;
+	while (!ringbufRead(&cmdQueue, &entry, sizeof(entry))) {
+		switch (entry.cmd) {
+			case EMUCMD_CONTHALT:
+				if (halt) {
+					halt = 0;
+					shmexportSetHalted(0);
+					// Step off the breakpoint we are sitting on
+					if (emuSCRptr->IAR == breakPoint) {
+						emuStep();
+					}
+				} else {
+					stop();
+				}
+				break;
+			case EMUCMD_STEP:
+				emuStep();
+				break;
+			case EMUCMD_BREAKPOINT:
+				breakPoint = entry.arg;
+				break;
+			case EMUCMD_MEMADDR:
+				memAddr = entry.arg;
+				break;
+			case EMUCMD_MEMVIRT:
+				memVirt = entry.arg;
+				break;
+			case EMUCMD_FLIGHTREC:
+				flightrecDump("Requested", 0);
+				break;
+			case EMUCMD_HOSTKEY:
+				ioHostKeysPending();
+				break;
+			case EMUCMD_QUIT:
+				quit = 1;
+				break;
+			default:
+				break;
+		}
+		// emuRun() publishes it next, no need to wake ourselves
+		atomic_store_explicit(&snapRequest, 1, memory_order_relaxed);
+	}
+}
+
+// A second one means shutdown is stuck, die the usual way
+void emuQuitHandler (int sig) {
+	if (emuQuitSignal) {
+		signal(sig, SIG_DFL);
+		raise(sig);
+	}
+	emuQuitSignal = 1;
+}
+
+void emuRun (void) {
+	while (!quit && !emuQuitSignal) {
+		if (ringbufLen(&cmdQueue)) {
+			processCmds();
+		}
+		if (atomic_load_explicit(&snapRequest, memory_order_relaxed)) {
+			atomic_store_explicit(&snapRequest, 0, memory_order_relaxed);
+			publishSnapshot();
+		}
+		if (halt) {
+			emuSleep(0);
+			continue;
+		}
+		if (emuSCRptr->IAR == breakPoint) {
+			flightrecDump("Breakpoint", 0);
+			stop();
+			atomic_store_explicit(&snapRequest, 1, memory_order_relaxed);
+			continue;
+		}
+		if (getWaitState()) {
+			emuWaitIdle(1);
+			continue;
+		}
+		emuStep();
+	}
+}
+
+void* emuThreadMain (void* arg) {
+	(void)arg;
+	emuRun();
+	return NULL;
+}
+
+int emuStart (void) {
+	quit = 0;
+	if (pthread_create(&emuThread, NULL, emuThreadMain, NULL)) {
+		printf("Error creating emulation thread\n");
+		return -1;
+	}
+	return 0;
+}
+
+void emuStop (void) {
+	while (emuSendCmd(EMUCMD_QUIT, 0)) {
+		struct timespec idle = {0, 1000000};
+		nanosleep(&idle, NULL);
+	}
+	pthread_join(emuThread, NULL);
+}
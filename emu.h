@@ -0,0 +1,74 @@
+// Emulation Thread
+#ifndef _EMU
+#define _EMU
+#include <stdint.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include "defs.h"
+#include "romp.h"
+#include "mda.h"
+
+#define MEMPANEROWS 16
+#define MEMPANEBYTES (MEMPANEROWS*8)	// Enough for a hex dump or 4 byte instructions
+#define DISPANEROWS 16
+#define DISPANEBACK 32	// Bytes before IAR, for context rows above it
+#define DISPANEBYTES (DISPANEBACK + (DISPANEROWS*4))
+
+// Control commands from the GUI, applied by the emulation thread between instructions
+#define EMUCMD_CONTHALT		0	// Toggle continue/halt
+#define EMUCMD_STEP				1	// Single step while halted
+#define EMUCMD_BREAKPOINT	2	// arg is the new IAR breakpoint
+#define EMUCMD_MEMADDR		3	// arg is the memory panel start address
+#define EMUCMD_QUIT				4
+#define EMUCMD_MEMVIRT		5	// arg is 1 to show the memory panel through the MMU
+#define EMUCMD_FLIGHTREC	6	// Dump the flight recorder
+#define EMUCMD_HOSTKEY		7	// Host keys were queued with ioHostKey()
+
+#define EMUCMDMAX 64	// Queue size in commands, must be a power of two
+
+struct emuCmd {
+	uint32_t cmd;
+	uint32_t arg;
+};
+
+// Consistent copy of what the GUI displays
+struct emuSnapshot {
+	uint32_t GPR[16];
+	union SCRs SCR;
+	uint32_t memAddr;
+	uint8_t memVirt;
+	uint8_t memBytes[MEMPANEBYTES];
+	uint32_t disAddr;	// IAR - DISPANEBACK
+	uint8_t disBytes[DISPANEBYTES];
+	uint8_t dispCode;
+	uint8_t halted;
+	uint64_t instCount;
+	uint64_t emuTime;
+	uint32_t instCounter[256];
+	uint64_t tlbHits;
+	uint64_t tlbMisses;
+	struct structmda mda;
+};
+
+// Seqlock, seq is odd while the emulation thread is writing snap
+struct emuSeqlock {
+	_Atomic uint32_t seq;
+	struct emuSnapshot snap;
+};
+
+// Set by SIGINT/SIGTERM, the run loops stop and shut down normally
+extern volatile sig_atomic_t emuQuitSignal;
+
+void emuinit (uint8_t* memptr, uint32_t* GPRptr, union SCRs* SCRptr, struct structmda* mdaptr, uint8_t* dispCodeptr);
+void emuStep (void);
+int emuWaitIdle (int pace);
+void emuRun (void);
+int emuStart (void);
+void emuStop (void);
+int emuSendCmd (uint32_t cmd, uint32_t arg);
+void emuWake (void);
+void emuRequestSnapshot (void);
+void emuReadSnapshot (struct emuSnapshot* snap);
+void emuQuitHandler (int sig);
+
+#endif
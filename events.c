@@ -0,0 +1,73 @@
+// Emulated Time and Device Event Scheduler
+#include <stdio.h>
+#include <stdint.h>
+
+#include "events.h"
+
+uint64_t emuTime;
+uint64_t eventDeadline[EVENT_MAX];
+uint64_t nextDeadline;
+
+void updateNextDeadline (void) {
+	nextDeadline = EVENT_NEVER;
+	for (int i = 0; i < EVENT_MAX; i++) {
+		if (eventDeadline[i] < nextDeadline) {
+			nextDeadline = eventDeadline[i];
+		}
+	}
+}
+
+void eventsinit (void) {
+	emuTime = 0;
+	for (int i = 0; i < EVENT_MAX; i++) {
+		eventDeadline[i] = EVENT_NEVER;
+	}
+	nextDeadline = EVENT_NEVER;
+}
+
+uint64_t getEmuTime (void) {
+	return emuTime;
+}
+
+void advanceEmuTime (uint64_t ns) {
+	emuTime += ns;
+}
+
+// Replaces any outstanding deadline for this ID.
+void scheduleEvent (uint8_t id, uint64_t delay) {
+	eventDeadline[id] = emuTime + delay;
+	updateNextDeadline();
+}
+
+// Only moves the deadline earlier, never later.
+void scheduleEventBefore (uint8_t id, uint64_t delay) {
+	if ((emuTime + delay) < eventDeadline[id]) {
+		scheduleEvent(id, delay);
+	}
+}
+
+void cancelEvent (uint8_t id) {
+	eventDeadline[id] = EVENT_NEVER;
+	updateNextDeadline();
+}
+
+uint64_t getEventDeadline (uint8_t id) {
+	return eventDeadline[id];
+}
+
+uint64_t nextEventTime (void) {
+	return nextDeadline;
+}
+
+// Returns the ID of an event whose deadline has passed (clearing it) or -1.
+int popDueEvent (void) {
+	if (emuTime < nextDeadline) {return -1;}
+	for (int i = 0; i < EVENT_MAX; i++) {
+		if (eventDeadline[i] <= emuTime) {
+			eventDeadline[i] = EVENT_NEVER;
+			updateNextDeadline();
+			return i;
+		}
+	}
+	return -1;
+}
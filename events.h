@@ -0,0 +1,29 @@
+// Emulated Time and Device Event Scheduler
+#ifndef _EVENTS
+#define _EVENTS
+#include <stdint.h>
+
+// Emulated time is kept in ns and advances by a nominal instruction time
+// (~2 MIPS) every iocycle(). Device latencies are given in emulated time.
+#define NS_PER_INST	500
+#define NS_PER_US		1000
+#define NS_PER_MS		1000000
+
+#define EVENT_NEVER	UINT64_MAX
+
+// Event IDs, one outstanding deadline per ID. Dispatched in iocycle().
+#define EVENT_KBADPT	0
+#define EVENT_RTC			1
+#define EVENT_MAX			8
+
+void eventsinit (void);
+uint64_t getEmuTime (void);
+void advanceEmuTime (uint64_t ns);
+void scheduleEvent (uint8_t id, uint64_t delay);
+void scheduleEventBefore (uint8_t id, uint64_t delay);
+void cancelEvent (uint8_t id);
+uint64_t getEventDeadline (uint8_t id);
+uint64_t nextEventTime (void);
+int popDueEvent (void);
+
+#endif
@@ -0,0 +1,41 @@
+// Instruction Flight Recorder
+#include <stdio.h>
+#include <stdint.h>
+
+#include "flightrec.h"
+#include "disasm.h"
+
+struct flightRec flightRing[FLIGHTRECSIZE];
+uint64_t flightLast = UINT64_MAX;	// Nothing recorded yet
+int flightAutoDumps = 0;
+FILE *flightfile = NULL;
+
+void flightrecDump (const char *reason, int automatic) {
+	if (flightLast == UINT64_MAX) {return;}
+	if (automatic && ++flightAutoDumps > FLIGHTRECAUTOMAX) {
+		if (flightAutoDumps == FLIGHTRECAUTOMAX + 1) {
+			printf("Flight recorder: %d automatic dumps written, no more this run\n", FLIGHTRECAUTOMAX);
+		}
+		return;
+	}
+	if (!flightfile) {
+		flightfile = fopen(FLIGHTRECFILE, "w");
+		if (!flightfile) {
+			printf("Error opening %s\n", FLIGHTRECFILE);
+			return;
+		}
+	}
+
+	uint64_t count = (flightLast >= FLIGHTRECSIZE) ? FLIGHTRECSIZE : flightLast + 1;
+	fprintf(flightfile, "--- %s at inst %llu, last %llu instructions ---\n", reason, (unsigned long long)flightLast, (unsigned long long)count);
+	for (uint64_t n = flightLast + 1 - count; n <= flightLast; n++) {
+		struct flightRec *rec = &flightRing[n & (FLIGHTRECSIZE - 1)];
+		char text[DISASMMAX];
+		if (disasm(rec->inst, text, sizeof(text)) == 4) {
+			fprintf(flightfile, "%10llu 0x%08X: 0x%08X\t%-28s ICS 0x%04X CS 0x%04X GPR15 0x%08X\n", (unsigned long long)n, rec->iar, rec->inst, text, rec->ics, rec->cs, rec->link);
+		} else {
+			fprintf(flightfile, "%10llu 0x%08X: 0x%04X    \t%-28s ICS 0x%04X CS 0x%04X GPR15 0x%08X\n", (unsigned long long)n, rec->iar, rec->inst >> 16, text, rec->ics, rec->cs, rec->link);
+		}
+	}
+	fflush(flightfile);
+}
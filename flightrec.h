@@ -0,0 +1,37 @@
+// Instruction Flight Recorder
+#ifndef _FLIGHTREC
+#define _FLIGHTREC
+#include <stdint.h>
+
+// Always on ring of the last FLIGHTRECSIZE instructions, written out to
+// FLIGHTRECFILE on program/machine checks, checkstop, breakpoints, dump
+// triggers and on request.
+#define FLIGHTRECSIZE	4096	// Must be a power of two
+#define FLIGHTRECFILE	"flightrec.txt"
+#define FLIGHTRECAUTOMAX	32	// Automatic dumps per run, checks can repeat in a loop
+
+struct flightRec {
+	uint32_t iar;
+	uint32_t inst;
+	uint32_t link;	// GPR15
+	uint16_t ics;
+	uint16_t cs;
+};
+
+extern struct flightRec flightRing[FLIGHTRECSIZE];
+extern uint64_t flightLast;	// Instruction count of the newest record
+
+void flightrecDump (const char *reason, int automatic);
+
+// Called from fetch() before each instruction is decoded
+static inline void flightrecRecord (uint64_t count, uint32_t iar, uint32_t inst, uint32_t link, uint32_t ics, uint32_t cs) {
+	struct flightRec *rec = &flightRing[count & (FLIGHTRECSIZE - 1)];
+	rec->iar = iar;
+	rec->inst = inst;
+	rec->link = link;
+	rec->ics = ics;
+	rec->cs = cs;
+	flightLast = count;
+}
+
+#endif
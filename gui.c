@@ -1,12 +1,23 @@
 // IBM PC RT Emulator GUI
+#ifndef HEADLESS
 #include "gui.h"
 
 SDL_Window *window;
 SDL_Renderer *rend;
 SDL_Surface *surface;
 TTF_Font *font;
-SDL_Texture *fontTexture[CHARSINFONT];
-SDL_Color textColor = {0, 255, 0, SDL_ALPHA_OPAQUE};
+SDL_Texture *glyphAtlas;
+// Whole MDA screen as one quad per cell, only changed rows get rebuilt
+SDL_Vertex mdaVerts[MDA_COLS*MDA_ROWS*4];
+int mdaIndices[MDA_COLS*MDA_ROWS*6];
+uint32_t mdaRowSeen[MDA_ROWS];
+int mdaRedrawAll = 1;
+int mdaBlinkPhase = 0;
+// All debug panel text, rebuilt only when some text changes
+SDL_Vertex panelVerts[PANELCHARMAX*4];
+int panelIndices[PANELCHARMAX*6];
+int panelChars = 0;
+int panelDirty = 1;
 struct Text_Texture textlist[TEXTMAX];
 struct Text_Texture textboxlist[TEXTMAX];
 struct Text_Texture buttonlist[TEXTMAX];
@@ -14,19 +25,126 @@ int selectedbox = TEXTMAX+1;
 uint64_t prevTicks = 0;
 int blinkOn = 0;
 
-uint32_t iarbreakptval;
-uint32_t memaddrval;
-int continuebtn = 0;
-int singlestep = 0;
-
-uint32_t *GPRlocptr;
-union SCRs *SCRlocptr;
-uint8_t *memlocptr;
-uint8_t *mdalocptr;
-uint8_t *dispCodelocptr;
+// Latest state published by the emulation thread
+struct emuSnapshot snap;
+struct structmda *mdalocptr = &snap.mda;
+// Memory pane
+uint32_t memPaneAddr = 0;
+int memPaneDisasm = 0;
+int memPaneVirt = 0;
+uint8_t memPaneLen[MEMPANEROWS];
+// Disassembly pane
+struct disCacheEntry disCache[DISCACHESIZE];
+uint32_t breakPointVal = 0;
+// Perf HUD, deltas against the values from the last update
+uint64_t hudTicks = 0;
+uint64_t hudInstCount = 0;
+uint32_t hudInstCounter[256];
+uint64_t hudTLBHits = 0;
+uint64_t hudTLBMisses = 0;
+uint64_t hudEmuTime = 0;
+struct hostprofCounts hudHostCounts;
+struct perfSamples hudSamples;
 
 uint16_t unicodeMappings[256] = {0x00a0, 0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000a, 0x000b, 0x000c, 0x000d, 0x000e, 0x000f, 0x0010, 0x0011, 0x0012, 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001a, 0x001b, 0x001c, 0x001d, 0x001e, 0x001f, 0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002a, 0x002b, 0x002c, 0x002d, 0x002e, 0x002f, 0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x003a, 0x003b, 0x003c, 0x003d, 0x003e, 0x003f, 0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x004a, 0x004b, 0x004c, 0x004d, 0x004e, 0x004f, 0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059, 0x005a, 0x005b, 0x005c, 0x005d, 0x005e, 0x005f, 0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x006a, 0x006b, 0x006c, 0x006d, 0x006e, 0x006f, 0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077, 0x0078, 0x0079, 0x007a, 0x007b, 0x007c, 0x007d, 0x007e, 0x007f, 0x00c7, 0x00fc, 0x00e9, 0x00e2, 0x00e4, 0x00e0, 0x00e5, 0x00e7, 0x00ea, 0x00eb, 0x00e8, 0x00ef, 0x00ee, 0x00ec, 0x00c4, 0x00c5, 0x00c9, 0x00e6, 0x00c6, 0x00f4, 0x00f6, 0x00f2, 0x00fb, 0x00f9, 0x00ff, 0x00d6, 0x00dc, 0x00a2, 0x00a3, 0x00a5, 0x20a7, 0x0192, 0x00e1, 0x00ed, 0x00f3, 0x00fa, 0x00f1, 0x00d1, 0x00aa, 0x00ba, 0x00bf, 0x2310, 0x00ac, 0x00bd, 0x00bc, 0x00a1, 0x00ab, 0x00bb, 0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556, 0x2555, 0x2563, 0x2551, 0x2557, 0x255d, 0x255c, 0x255b, 0x2510, 0x2514, 0x2534, 0x252c, 0x251c, 0x2500, 0x253c, 0x255e, 0x255f, 0x255a, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256c, 0x2567, 0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256b, 0x256a, 0x2518, 0x250c, 0x2588, 0x2584, 0x258c, 0x2590, 0x2580, 0x03b1, 0x00df, 0x0393, 0x03c0, 0x03a3, 0x03c3, 0x00b5, 0x03c4, 0x03a6, 0x0398, 0x03a9, 0x03b4, 0x221e, 0x03c6, 0x03b5, 0x2229, 0x2261, 0x00b1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00f7, 0x2248, 0x00b0, 0x2219, 0x00b7, 0x221a, 0x207f, 0x00b2, 0x25a0, 0x00a0};
 
+// SDL scancode to RT keyboard (scan code set 3) make codes, 0 is unmapped.
+uint8_t rtScanCodes[SDL_NUM_SCANCODES] = {
+	[SDL_SCANCODE_ESCAPE] = 0x08, [SDL_SCANCODE_F1] = 0x07, [SDL_SCANCODE_F2] = 0x0F, [SDL_SCANCODE_F3] = 0x17,
+	[SDL_SCANCODE_F4] = 0x1F, [SDL_SCANCODE_F5] = 0x27, [SDL_SCANCODE_F6] = 0x2F, [SDL_SCANCODE_F7] = 0x37,
+	[SDL_SCANCODE_F8] = 0x3F, [SDL_SCANCODE_F9] = 0x47, [SDL_SCANCODE_F10] = 0x4F, [SDL_SCANCODE_F11] = 0x56,
+	[SDL_SCANCODE_F12] = 0x5E, [SDL_SCANCODE_PRINTSCREEN] = 0x57, [SDL_SCANCODE_SCROLLLOCK] = 0x5F, [SDL_SCANCODE_PAUSE] = 0x62,
+	[SDL_SCANCODE_GRAVE] = 0x0E, [SDL_SCANCODE_1] = 0x16, [SDL_SCANCODE_2] = 0x1E, [SDL_SCANCODE_3] = 0x26,
+	[SDL_SCANCODE_4] = 0x25, [SDL_SCANCODE_5] = 0x2E, [SDL_SCANCODE_6] = 0x36, [SDL_SCANCODE_7] = 0x3D,
+	[SDL_SCANCODE_8] = 0x3E, [SDL_SCANCODE_9] = 0x46, [SDL_SCANCODE_0] = 0x45, [SDL_SCANCODE_MINUS] = 0x4E,
+	[SDL_SCANCODE_EQUALS] = 0x55, [SDL_SCANCODE_BACKSPACE] = 0x66, [SDL_SCANCODE_TAB] = 0x0D, [SDL_SCANCODE_Q] = 0x15,
+	[SDL_SCANCODE_W] = 0x1D, [SDL_SCANCODE_E] = 0x24, [SDL_SCANCODE_R] = 0x2D, [SDL_SCANCODE_T] = 0x2C,
+	[SDL_SCANCODE_Y] = 0x35, [SDL_SCANCODE_U] = 0x3C, [SDL_SCANCODE_I] = 0x43, [SDL_SCANCODE_O] = 0x44,
+	[SDL_SCANCODE_P] = 0x4D, [SDL_SCANCODE_LEFTBRACKET] = 0x54, [SDL_SCANCODE_RIGHTBRACKET] = 0x5B, [SDL_SCANCODE_BACKSLASH] = 0x5C,
+	[SDL_SCANCODE_CAPSLOCK] = 0x14, [SDL_SCANCODE_A] = 0x1C, [SDL_SCANCODE_S] = 0x1B, [SDL_SCANCODE_D] = 0x23,
+	[SDL_SCANCODE_F] = 0x2B, [SDL_SCANCODE_G] = 0x34, [SDL_SCANCODE_H] = 0x33, [SDL_SCANCODE_J] = 0x3B,
+	[SDL_SCANCODE_K] = 0x42, [SDL_SCANCODE_L] = 0x4B, [SDL_SCANCODE_SEMICOLON] = 0x4C, [SDL_SCANCODE_APOSTROPHE] = 0x52,
+	[SDL_SCANCODE_RETURN] = 0x5A, [SDL_SCANCODE_LSHIFT] = 0x12, [SDL_SCANCODE_NONUSBACKSLASH] = 0x13, [SDL_SCANCODE_Z] = 0x1A,
+	[SDL_SCANCODE_X] = 0x22, [SDL_SCANCODE_C] = 0x21, [SDL_SCANCODE_V] = 0x2A, [SDL_SCANCODE_B] = 0x32,
+	[SDL_SCANCODE_N] = 0x31, [SDL_SCANCODE_M] = 0x3A, [SDL_SCANCODE_COMMA] = 0x41, [SDL_SCANCODE_PERIOD] = 0x49,
+	[SDL_SCANCODE_SLASH] = 0x4A, [SDL_SCANCODE_RSHIFT] = 0x59, [SDL_SCANCODE_LCTRL] = 0x11, [SDL_SCANCODE_LALT] = 0x19,
+	[SDL_SCANCODE_SPACE] = 0x29, [SDL_SCANCODE_RALT] = 0x39, [SDL_SCANCODE_RCTRL] = 0x58, [SDL_SCANCODE_INSERT] = 0x67,
+	[SDL_SCANCODE_HOME] = 0x6E, [SDL_SCANCODE_PAGEUP] = 0x6F, [SDL_SCANCODE_DELETE] = 0x64, [SDL_SCANCODE_END] = 0x65,
+	[SDL_SCANCODE_PAGEDOWN] = 0x6D, [SDL_SCANCODE_UP] = 0x63, [SDL_SCANCODE_LEFT] = 0x61, [SDL_SCANCODE_DOWN] = 0x60,
+	[SDL_SCANCODE_RIGHT] = 0x6A, [SDL_SCANCODE_NUMLOCKCLEAR] = 0x76, [SDL_SCANCODE_KP_DIVIDE] = 0x77, [SDL_SCANCODE_KP_MULTIPLY] = 0x7E,
+	[SDL_SCANCODE_KP_MINUS] = 0x84, [SDL_SCANCODE_KP_7] = 0x6C, [SDL_SCANCODE_KP_8] = 0x75, [SDL_SCANCODE_KP_9] = 0x7D,
+	[SDL_SCANCODE_KP_PLUS] = 0x7C, [SDL_SCANCODE_KP_4] = 0x6B, [SDL_SCANCODE_KP_5] = 0x73, [SDL_SCANCODE_KP_6] = 0x74,
+	[SDL_SCANCODE_KP_1] = 0x69, [SDL_SCANCODE_KP_2] = 0x72, [SDL_SCANCODE_KP_3] = 0x7A, [SDL_SCANCODE_KP_0] = 0x70,
+	[SDL_SCANCODE_KP_PERIOD] = 0x71, [SDL_SCANCODE_KP_ENTER] = 0x79
+};
+
+void build_glyph_atlas (void) {
+	// Foreground and background for each variant
+	SDL_Color fgColors[GLYPH_VARIANTS] = {{0, 200, 0, 255}, {100, 255, 100, 255}, {0, 200, 0, 255}, {100, 255, 100, 255}, {0, 0, 0, 255}};
+	SDL_Color bgColors[GLYPH_VARIANTS] = {{0, 0, 0, 255}, {0, 0, 0, 255}, {0, 0, 0, 255}, {0, 0, 0, 255}, {0, 200, 0, 255}};
+
+	SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(0, ATLASCOLS*CHARW, ATLASROWS*CHARH*GLYPH_VARIANTS, 32, SDL_PIXELFORMAT_RGBA32);
+	if (atlas == NULL) {
+		printf("Error creating glyph atlas surface: %s\n", SDL_GetError());
+		return;
+	}
+	for (int v = 0; v < GLYPH_VARIANTS; v++) {
+		uint32_t fg = SDL_MapRGB(atlas->format, fgColors[v].r, fgColors[v].g, fgColors[v].b);
+		uint32_t bg = SDL_MapRGB(atlas->format, bgColors[v].r, bgColors[v].g, bgColors[v].b);
+		for (int i = 0; i < CHARSINFONT; i++) {
+			SDL_Rect cell = {(i % ATLASCOLS) * CHARW, ((v * ATLASROWS) + (i / ATLASCOLS)) * CHARH, CHARW, CHARH};
+			SDL_FillRect(atlas, &cell, bg);
+			SDL_Surface *char_surf = TTF_RenderGlyph_Solid(font, unicodeMappings[i], fgColors[v]);
+			if (char_surf != NULL) {
+				SDL_BlitScaled(char_surf, NULL, atlas, &cell);
+				SDL_FreeSurface(char_surf);
+			} else {
+				printf("Error rendering char surface: %s\n", TTF_GetError());
+			}
+			if (v == GLYPH_UNDERLINE || v == GLYPH_INTENSE_UNDERLINE) {
+				SDL_Rect underline = {cell.x, cell.y + CHARH - 2, CHARW, 1};
+				SDL_FillRect(atlas, &underline, fg);
+			}
+		}
+	}
+	glyphAtlas = SDL_CreateTextureFromSurface(rend, atlas);
+	if (glyphAtlas == NULL) {
+		printf("Error creating texture from surface: %s\n", SDL_GetError());
+	}
+	SDL_FreeSurface(atlas);
+}
+
+// Fill in one quad (4 vertices) drawing glyph from the atlas at x, y.
+void setGlyphQuad (SDL_Vertex *verts, int x, int y, uint8_t glyph, int variant) {
+	float u0 = (float)((glyph % ATLASCOLS) * CHARW) / (ATLASCOLS * CHARW);
+	float u1 = (float)(((glyph % ATLASCOLS) + 1) * CHARW) / (ATLASCOLS * CHARW);
+	float v0 = (float)(((variant * ATLASROWS) + (glyph / ATLASCOLS)) * CHARH) / (ATLASROWS * CHARH * GLYPH_VARIANTS);
+	float v1 = (float)(((variant * ATLASROWS) + (glyph / ATLASCOLS) + 1) * CHARH) / (ATLASROWS * CHARH * GLYPH_VARIANTS);
+	SDL_Color white = {255, 255, 255, 255};
+	verts[0].position.x = x;					verts[0].position.y = y;
+	verts[1].position.x = x + CHARW;	verts[1].position.y = y;
+	verts[2].position.x = x + CHARW;	verts[2].position.y = y + CHARH;
+	verts[3].position.x = x;					verts[3].position.y = y + CHARH;
+	verts[0].tex_coord.x = u0;	verts[0].tex_coord.y = v0;
+	verts[1].tex_coord.x = u1;	verts[1].tex_coord.y = v0;
+	verts[2].tex_coord.x = u1;	verts[2].tex_coord.y = v1;
+	verts[3].tex_coord.x = u0;	verts[3].tex_coord.y = v1;
+	for (int i = 0; i < 4; i++) {
+		verts[i].color = white;
+	}
+}
+
+void setQuadIndices (int *indices, int quads) {
+	for (int i = 0; i < quads; i++) {
+		indices[(i*6)+0] = (i*4)+0;
+		indices[(i*6)+1] = (i*4)+1;
+		indices[(i*6)+2] = (i*4)+2;
+		indices[(i*6)+3] = (i*4)+0;
+		indices[(i*6)+4] = (i*4)+2;
+		indices[(i*6)+5] = (i*4)+3;
+	}
+}
+
 void gui_init (void) {
 	if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
 		printf("Error initializing SDL: %s\n", SDL_GetError());
@@ -35,7 +153,7 @@ void gui_init (void) {
 	window = SDL_CreateWindow("IBM PC RT Emulator",
 															SDL_WINDOWPOS_CENTERED,
 															SDL_WINDOWPOS_CENTERED,
-															800, 600, 0);
+															WINDOWW, WINDOWH, 0);
 	rend = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
 	SDL_SetRenderDrawColor(rend, 0, 0, 0, SDL_ALPHA_OPAQUE);
 	SDL_RenderClear(rend);
@@ -47,25 +165,16 @@ void gui_init (void) {
 	if (font == NULL) {
 		printf("Error loading font file: %s\n", TTF_GetError());
 	}
-	SDL_Surface *char_surf;
-	SDL_Color char_color = {0, 200, 0, 0};
-	for (int i = 0; i < CHARSINFONT; i++) {
-		char_surf = TTF_RenderGlyph_Solid(font, unicodeMappings[i], char_color);
-		if (char_surf != NULL){
-			fontTexture[i] = SDL_CreateTextureFromSurface(rend, char_surf);
-			if (fontTexture[i] == NULL) {
-				printf("Error creating texture from surface: %s\n", SDL_GetError());
-			}
-		} else {
-			printf("Error rendering char surface: %s\n", TTF_GetError());
-		}
-		SDL_FreeSurface(char_surf);
-	}
-	
+	build_glyph_atlas();
+
+	// Quad indices never change
+	setQuadIndices(mdaIndices, MDA_COLS*MDA_ROWS);
+	setQuadIndices(panelIndices, PANELCHARMAX);
+
 	for (int i=0; i<TEXTMAX; i++) {
-		textlist[i].texture = NULL;
-		textboxlist[i].texture = NULL;
-		buttonlist[i].texture = NULL;
+		textlist[i].used = 0;
+		textboxlist[i].used = 0;
+		buttonlist[i].used = 0;
 	}
 
 	setup_text_textures();
@@ -73,43 +182,39 @@ void gui_init (void) {
 
 void gui_close (void) {
 	TTF_CloseFont(font);
-	for (int i = 0; i < CHARSINFONT; i++) {
-		SDL_DestroyTexture(fontTexture[i]);
-	}
+	SDL_DestroyTexture(glyphAtlas);
 	SDL_DestroyRenderer(rend);
 	SDL_DestroyWindow(window);
 	SDL_Quit();
 }
 
-void generateTextTexture (struct Text_Texture *textureptr, const char *text, SDL_Color textColor, int x, int y, int textbox) {
-	if (textureptr->texture != NULL) {SDL_DestroyTexture(textureptr->texture); textureptr->texture = NULL;}
-	SDL_Surface* textSurface = TTF_RenderText_Solid( font, text, textColor );
-	if (textSurface != NULL){
-		textureptr->texture = SDL_CreateTextureFromSurface(rend, textSurface);
-		if (textureptr->texture == NULL) {
-			printf("Error creating texture from surface: %s\n", SDL_GetError());
-		} else {
-			strcpy(textureptr->text, text);
-			if (textbox == TEXTBOX) {
-				textureptr->rect.x = x+2;
-				textureptr->rect.y = y;
-				textureptr->rect.w = textSurface->w;
-				textureptr->rect.h = textSurface->h;
-				textureptr->sqrrect.x = x;
-				textureptr->sqrrect.y = y;
-				textureptr->sqrrect.w = textSurface->w+4;
-				textureptr->sqrrect.h = textSurface->h;
-			} else if (textbox == TEXT) {
-				textureptr->rect.x = x;
-				textureptr->rect.y = y;
-				textureptr->rect.w = textSurface->w;
-				textureptr->rect.h = textSurface->h;
-			}
-		}
-	} else {
-		printf("Error rendering char surface: %s\n", TTF_GetError());
+void generateTextTexture (struct Text_Texture *textureptr, const char *text, int x, int y, int textbox) {
+	if (textbox == UPDATETEXT) {
+		// Nothing to redraw if the value didn't change
+		if (!strcmp(textureptr->text, text)) {return;}
+		snprintf(textureptr->text, sizeof(textureptr->text), "%s", text);
+		panelDirty = 1;
+		return;
 	}
-	SDL_FreeSurface(textSurface);
+	snprintf(textureptr->text, sizeof(textureptr->text), "%s", text);
+	textureptr->used = 1;
+	int w = strlen(textureptr->text) * CHARW;
+	if (textbox == TEXTBOX) {
+		textureptr->rect.x = x+2;
+		textureptr->rect.y = y;
+		textureptr->rect.w = w;
+		textureptr->rect.h = CHARH;
+		textureptr->sqrrect.x = x;
+		textureptr->sqrrect.y = y;
+		textureptr->sqrrect.w = w+4;
+		textureptr->sqrrect.h = CHARH;
+	} else if (textbox == TEXT) {
+		textureptr->rect.x = x;
+		textureptr->rect.y = y;
+		textureptr->rect.w = w;
+		textureptr->rect.h = CHARH;
+	}
+	panelDirty = 1;
 }
 
 void updateTextTexture (struct Text_Texture *textureptr, char character) {
@@ -127,191 +232,402 @@ void updateTextTexture (struct Text_Texture *textureptr, char character) {
 			break;
 		}
 	}
+	panelDirty = 1;
+}
 
-	if (textureptr->texture != NULL) {SDL_DestroyTexture(textureptr->texture); textureptr->texture = NULL;}
-	SDL_Surface* textSurface = TTF_RenderText_Solid( font, textureptr->text, textColor );
-	if (textSurface != NULL){
-		textureptr->texture = SDL_CreateTextureFromSurface(rend, textSurface);
-		if (textureptr->texture == NULL) {
-			printf("Error creating texture from surface: %s\n", SDL_GetError());
+void add_panel_text (struct Text_Texture *texturelistptr) {
+	for (int i=0; i<TEXTMAX; i++) {
+		if (!texturelistptr[i].used) {continue;}
+		for (int j=0; texturelistptr[i].text[j] != '\0' && panelChars < PANELCHARMAX; j++) {
+			setGlyphQuad(&panelVerts[panelChars*4], texturelistptr[i].rect.x + (j*CHARW), texturelistptr[i].rect.y, texturelistptr[i].text[j], GLYPH_INTENSE);
+			panelChars++;
 		}
-	} else {
-		printf("Error rendering char surface: %s\n", TTF_GetError());
 	}
-	SDL_FreeSurface(textSurface);
 }
 
-void render_all_text (struct Text_Texture *texturelistptr) {
-	for (int i=0; i<TEXTMAX; i++) {
-		if (texturelistptr[i].texture == NULL) {break;}
-		SDL_RenderCopy(rend, texturelistptr[i].texture, NULL, &(texturelistptr[i].rect));
+void render_panel_text (void) {
+	if (panelDirty) {
+		panelChars = 0;
+		add_panel_text(textlist);
+		add_panel_text(textboxlist);
+		add_panel_text(buttonlist);
+		panelDirty = 0;
 	}
+	SDL_RenderGeometry(rend, glyphAtlas, panelVerts, panelChars*4, panelIndices, panelChars*6);
 }
 
 void render_all_textboxes (struct Text_Texture *texturelistptr) {
 	for (int i=0; i<TEXTMAX; i++) {
-		if (texturelistptr[i].texture == NULL) {break;}
+		if (!texturelistptr[i].used) {continue;}
 		if (blinkOn && selectedbox == i) {
 			SDL_SetRenderDrawColor(rend, 100, 255, 100, SDL_ALPHA_OPAQUE);
 		}
 		SDL_RenderDrawRect(rend, &(texturelistptr[i].sqrrect));
-		SDL_RenderCopy(rend, texturelistptr[i].texture, NULL, &(texturelistptr[i].rect));
 		SDL_SetRenderDrawColor(rend, 255, 255, 255, SDL_ALPHA_OPAQUE);
 	}
 }
 
 void render_all_buttons (struct Text_Texture *texturelistptr) {
 	for (int i=0; i<TEXTMAX; i++) {
-		if (texturelistptr[i].texture == NULL) {break;}
+		if (!texturelistptr[i].used) {continue;}
 		SDL_RenderDrawRect(rend, &(texturelistptr[i].sqrrect));
-		SDL_RenderCopy(rend, texturelistptr[i].texture, NULL, &(texturelistptr[i].rect));
 	}
 }
 
 void setup_text_textures (void) {
-	generateTextTexture(&textlist[0], "IAR:", textColor, CHARW*36, CHARH*25, TEXT);
-	generateTextTexture(&textlist[1], "0x00000000", textColor, CHARW*41, CHARH*25, TEXT);
-	generateTextTexture(&textlist[2], "IAR Breakpoint: 0x", textColor, CHARW*52, CHARH*25, TEXT);
-	generateTextTexture(&textlist[3], "GPR 0:", textColor, 0, CHARH*25, TEXT);
-	generateTextTexture(&textlist[4], "GPR 2:", textColor, 0, CHARH*26, TEXT);
-	generateTextTexture(&textlist[5], "GPR 4:", textColor, 0, CHARH*27, TEXT);
-	generateTextTexture(&textlist[6], "GPR 6:", textColor, 0, CHARH*28, TEXT);
-	generateTextTexture(&textlist[7], "GPR 8:", textColor, 0, CHARH*29, TEXT);
-	generateTextTexture(&textlist[8], "GPR10:", textColor, 0, CHARH*30, TEXT);
-	generateTextTexture(&textlist[9], "GPR12:", textColor, 0, CHARH*31, TEXT);
-	generateTextTexture(&textlist[10], "GPR14:", textColor, 0, CHARH*32, TEXT);
-	generateTextTexture(&textlist[11], "GPR 1:", textColor, CHARW*18, CHARH*25, TEXT);
-	generateTextTexture(&textlist[12], "GPR 3:", textColor, CHARW*18, CHARH*26, TEXT);
-	generateTextTexture(&textlist[13], "GPR 5:", textColor, CHARW*18, CHARH*27, TEXT);
-	generateTextTexture(&textlist[14], "GPR 7:", textColor, CHARW*18, CHARH*28, TEXT);
-	generateTextTexture(&textlist[15], "GPR 9:", textColor, CHARW*18, CHARH*29, TEXT);
-	generateTextTexture(&textlist[16], "GPR11:", textColor, CHARW*18, CHARH*30, TEXT);
-	generateTextTexture(&textlist[17], "GPR13:", textColor, CHARW*18, CHARH*31, TEXT);
-	generateTextTexture(&textlist[18], "GPR15:", textColor, CHARW*18, CHARH*32, TEXT);
-	generateTextTexture(&textlist[19], "0x00000000", textColor, CHARW*7, CHARH*25, TEXT);
-	generateTextTexture(&textlist[20], "0x00000000", textColor, CHARW*25, CHARH*25, TEXT);
-	generateTextTexture(&textlist[21], "0x00000000", textColor, CHARW*7, CHARH*26, TEXT);
-	generateTextTexture(&textlist[22], "0x00000000", textColor, CHARW*25, CHARH*26, TEXT);
-	generateTextTexture(&textlist[23], "0x00000000", textColor, CHARW*7, CHARH*27, TEXT);
-	generateTextTexture(&textlist[24], "0x00000000", textColor, CHARW*25, CHARH*27, TEXT);
-	generateTextTexture(&textlist[25], "0x00000000", textColor, CHARW*7, CHARH*28, TEXT);
-	generateTextTexture(&textlist[26], "0x00000000", textColor, CHARW*25, CHARH*28, TEXT);
-	generateTextTexture(&textlist[27], "0x00000000", textColor, CHARW*7, CHARH*29, TEXT);
-	generateTextTexture(&textlist[28], "0x00000000", textColor, CHARW*25, CHARH*29, TEXT);
-	generateTextTexture(&textlist[29], "0x00000000", textColor, CHARW*7, CHARH*30, TEXT);
-	generateTextTexture(&textlist[30], "0x00000000", textColor, CHARW*25, CHARH*30, TEXT);
-	generateTextTexture(&textlist[31], "0x00000000", textColor, CHARW*7, CHARH*31, TEXT);
-	generateTextTexture(&textlist[32], "0x00000000", textColor, CHARW*25, CHARH*31, TEXT);
-	generateTextTexture(&textlist[33], "0x00000000", textColor, CHARW*7, CHARH*32, TEXT);
-	generateTextTexture(&textlist[34], "0x00000000", textColor, CHARW*25, CHARH*32, TEXT);
-	generateTextTexture(&textlist[35], "Mem Addr: 0x", textColor, CHARW*36, CHARH*26, TEXT);
-	generateTextTexture(&textlist[36], "0x00000000", textColor, CHARW*36, CHARH*27, TEXT);
-	generateTextTexture(&textlist[37], "0x00000000", textColor, CHARW*47, CHARH*27, TEXT);
-	generateTextTexture(&textlist[38], "0x00000000", textColor, CHARW*58, CHARH*27, TEXT);
-	generateTextTexture(&textlist[39], "0x00000000", textColor, CHARW*69, CHARH*27, TEXT);
-	generateTextTexture(&textlist[40], "0x00000000", textColor, CHARW*36, CHARH*28, TEXT);
-	generateTextTexture(&textlist[41], "0x00000000", textColor, CHARW*47, CHARH*28, TEXT);
-	generateTextTexture(&textlist[42], "0x00000000", textColor, CHARW*58, CHARH*28, TEXT);
-	generateTextTexture(&textlist[43], "0x00000000", textColor, CHARW*69, CHARH*28, TEXT);
-	generateTextTexture(&textlist[44], "0x00000000", textColor, CHARW*36, CHARH*29, TEXT);
-	generateTextTexture(&textlist[45], "0x00000000", textColor, CHARW*47, CHARH*29, TEXT);
-	generateTextTexture(&textlist[46], "0x00000000", textColor, CHARW*58, CHARH*29, TEXT);
-	generateTextTexture(&textlist[47], "0x00000000", textColor, CHARW*69, CHARH*29, TEXT);
-	generateTextTexture(&textlist[48], "0x00000000", textColor, CHARW*36, CHARH*30, TEXT);
-	generateTextTexture(&textlist[49], "0x00000000", textColor, CHARW*47, CHARH*30, TEXT);
-	generateTextTexture(&textlist[50], "0x00000000", textColor, CHARW*58, CHARH*30, TEXT);
-	generateTextTexture(&textlist[51], "0x00000000", textColor, CHARW*69, CHARH*30, TEXT);
-	generateTextTexture(&textlist[52], "0x00000000", textColor, CHARW*36, CHARH*31, TEXT);
-	generateTextTexture(&textlist[53], "0x00000000", textColor, CHARW*47, CHARH*31, TEXT);
-	generateTextTexture(&textlist[54], "0x00000000", textColor, CHARW*58, CHARH*31, TEXT);
-	generateTextTexture(&textlist[55], "0x00000000", textColor, CHARW*69, CHARH*31, TEXT);
-	generateTextTexture(&textlist[56], "0x00000000", textColor, CHARW*36, CHARH*32, TEXT);
-	generateTextTexture(&textlist[57], "0x00000000", textColor, CHARW*47, CHARH*32, TEXT);
-	generateTextTexture(&textlist[58], "0x00000000", textColor, CHARW*58, CHARH*32, TEXT);
-	generateTextTexture(&textlist[59], "0x00000000", textColor, CHARW*69, CHARH*32, TEXT);
-	generateTextTexture(&textlist[60], "FP:", textColor, CHARW*58, CHARH*26, TEXT);
-	generateTextTexture(&textlist[61], "  ", textColor, CHARW*62, CHARH*26, TEXT);
-
-	//generateTextTexture(&textboxlist[0], "00800238", textColor, CHARW*70, CHARH*25, TEXTBOX);
-	generateTextTexture(&textboxlist[0], "00801a88", textColor, CHARW*70, CHARH*25, TEXTBOX);
-	generateTextTexture(&textboxlist[1], "00000000", textColor, CHARW*48, CHARH*26, TEXTBOX);
-	iarbreakptval = strtol(textboxlist[0].text, NULL, 16);
-	memaddrval = strtol(textboxlist[1].text, NULL, 16);
-	generateTextTexture(&buttonlist[0], "Cont/Halt", textColor, CHARW*70, CHARH*26, TEXTBOX);
-	generateTextTexture(&buttonlist[1], "S.S.", textColor, CHARW*65, CHARH*26, TEXTBOX);
+	generateTextTexture(&textlist[0], "IAR:", CHARW*36, CHARH*25, TEXT);
+	generateTextTexture(&textlist[1], "0x00000000", CHARW*41, CHARH*25, TEXT);
+	generateTextTexture(&textlist[2], "IAR Breakpoint: 0x", CHARW*52, CHARH*25, TEXT);
+	generateTextTexture(&textlist[3], "GPR 0:", 0, CHARH*25, TEXT);
+	generateTextTexture(&textlist[4], "GPR 2:", 0, CHARH*26, TEXT);
+	generateTextTexture(&textlist[5], "GPR 4:", 0, CHARH*27, TEXT);
+	generateTextTexture(&textlist[6], "GPR 6:", 0, CHARH*28, TEXT);
+	generateTextTexture(&textlist[7], "GPR 8:", 0, CHARH*29, TEXT);
+	generateTextTexture(&textlist[8], "GPR10:", 0, CHARH*30, TEXT);
+	generateTextTexture(&textlist[9], "GPR12:", 0, CHARH*31, TEXT);
+	generateTextTexture(&textlist[10], "GPR14:", 0, CHARH*32, TEXT);
+	generateTextTexture(&textlist[11], "GPR 1:", CHARW*18, CHARH*25, TEXT);
+	generateTextTexture(&textlist[12], "GPR 3:", CHARW*18, CHARH*26, TEXT);
+	generateTextTexture(&textlist[13], "GPR 5:", CHARW*18, CHARH*27, TEXT);
+	generateTextTexture(&textlist[14], "GPR 7:", CHARW*18, CHARH*28, TEXT);
+	generateTextTexture(&textlist[15], "GPR 9:", CHARW*18, CHARH*29, TEXT);
+	generateTextTexture(&textlist[16], "GPR11:", CHARW*18, CHARH*30, TEXT);
+	generateTextTexture(&textlist[17], "GPR13:", CHARW*18, CHARH*31, TEXT);
+	generateTextTexture(&textlist[18], "GPR15:", CHARW*18, CHARH*32, TEXT);
+	generateTextTexture(&textlist[19], "0x00000000", CHARW*7, CHARH*25, TEXT);
+	generateTextTexture(&textlist[20], "0x00000000", CHARW*25, CHARH*25, TEXT);
+	generateTextTexture(&textlist[21], "0x00000000", CHARW*7, CHARH*26, TEXT);
+	generateTextTexture(&textlist[22], "0x00000000", CHARW*25, CHARH*26, TEXT);
+	generateTextTexture(&textlist[23], "0x00000000", CHARW*7, CHARH*27, TEXT);
+	generateTextTexture(&textlist[24], "0x00000000", CHARW*25, CHARH*27, TEXT);
+	generateTextTexture(&textlist[25], "0x00000000", CHARW*7, CHARH*28, TEXT);
+	generateTextTexture(&textlist[26], "0x00000000", CHARW*25, CHARH*28, TEXT);
+	generateTextTexture(&textlist[27], "0x00000000", CHARW*7, CHARH*29, TEXT);
+	generateTextTexture(&textlist[28], "0x00000000", CHARW*25, CHARH*29, TEXT);
+	generateTextTexture(&textlist[29], "0x00000000", CHARW*7, CHARH*30, TEXT);
+	generateTextTexture(&textlist[30], "0x00000000", CHARW*25, CHARH*30, TEXT);
+	generateTextTexture(&textlist[31], "0x00000000", CHARW*7, CHARH*31, TEXT);
+	generateTextTexture(&textlist[32], "0x00000000", CHARW*25, CHARH*31, TEXT);
+	generateTextTexture(&textlist[33], "0x00000000", CHARW*7, CHARH*32, TEXT);
+	generateTextTexture(&textlist[34], "0x00000000", CHARW*25, CHARH*32, TEXT);
+	generateTextTexture(&textlist[35], "Mem: 0x", MEMPANEX, 0, TEXT);
+	generateTextTexture(&textlist[60], "FP:", CHARW*58, CHARH*26, TEXT);
+	generateTextTexture(&textlist[61], "  ", CHARW*62, CHARH*26, TEXT);
+	generateTextTexture(&textlist[62], "MIPS:", 0, CHARH*33, TEXT);
+	generateTextTexture(&textlist[63], "Top ops:", 0, CHARH*34, TEXT);
+	generateTextTexture(&textlist[36], hostprofEnabled() ? "Host:" : "Host: build with -DHOSTPROF", 0, CHARH*35, TEXT);
+	generateTextTexture(&textlist[MEMPANETEXT], "Real Hex", MEMPANEX + (CHARW*38), 0, TEXT);
+	for (int i=0; i < MEMPANEROWS; i++) {
+		generateTextTexture(&textlist[MEMPANETEXT+1+i], "", MEMPANEX, CHARH*(i+1), TEXT);
+	}
+	generateTextTexture(&textlist[DISPANETEXT], "Disassembly at IAR", MEMPANEX, DISPANEY, TEXT);
+	for (int i=0; i < DISPANEROWS; i++) {
+		generateTextTexture(&textlist[DISPANETEXT+1+i], "", MEMPANEX, DISPANEY + (CHARH*(i+1)), TEXT);
+	}
+
+	//generateTextTexture(&textboxlist[0], "00800238", CHARW*70, CHARH*25, TEXTBOX);
+	generateTextTexture(&textboxlist[0], "00801a88", CHARW*70, CHARH*25, TEXTBOX);
+	generateTextTexture(&textboxlist[1], "00000000", MEMPANEX + (CHARW*7), 0, TEXTBOX);
+	sendTextboxValues();
+	generateTextTexture(&buttonlist[0], "Cont/Halt", CHARW*70, CHARH*26, TEXTBOX);
+	generateTextTexture(&buttonlist[1], "S.S.", CHARW*65, CHARH*26, TEXTBOX);
+	generateTextTexture(&buttonlist[2], "Hex/Dis", MEMPANEX + (CHARW*17), 0, TEXTBOX);
+	generateTextTexture(&buttonlist[3], "Real/Virt", MEMPANEX + (CHARW*26), 0, TEXTBOX);
+	generateTextTexture(&buttonlist[4], "Flight Rec", CHARW*37, CHARH*27, TEXTBOX);
 }
 
 void render_interface () {
-	render_all_text(textlist);
+	render_panel_text();
 	render_all_textboxes(textboxlist);
 	render_all_buttons(buttonlist);
 	SDL_RenderDrawLine(rend, 0, CHARH*25, 800, CHARH*25);
-	SDL_RenderDrawLine(rend, 175, CHARH*25, 175, 600);
-	SDL_RenderDrawLine(rend, 355, CHARH*25, 355, 600);
+	SDL_RenderDrawLine(rend, 175, CHARH*25, 175, CHARH*33);
+	SDL_RenderDrawLine(rend, 355, CHARH*25, 355, CHARH*33);
+	SDL_RenderDrawLine(rend, 0, CHARH*33, 800, CHARH*33);
 	SDL_RenderDrawLine(rend, 515, CHARH*25, 515, CHARH*26);
 	SDL_RenderDrawLine(rend, 355, CHARH*26, 800, CHARH*26);
 	SDL_RenderDrawLine(rend, 355, CHARH*27, 800, CHARH*27);
+	SDL_RenderDrawLine(rend, PANELW, 0, PANELW, WINDOWH);
+	SDL_RenderDrawLine(rend, PANELW, CHARH, WINDOWW, CHARH);
+	SDL_RenderDrawLine(rend, PANELW, DISPANEY, WINDOWW, DISPANEY);
+	SDL_RenderDrawLine(rend, PANELW, DISPANEY + CHARH, WINDOWW, DISPANEY + CHARH);
 }
 
-void romp_pointers(uint32_t *GPRptr, union SCRs *SCRptr, uint8_t* memptr, uint8_t* mdaptr, uint8_t* dispCodeptr) {
-	GPRlocptr = GPRptr;
-	SCRlocptr = SCRptr;
-	memlocptr = memptr;
-	mdalocptr = mdaptr;
-	dispCodelocptr = dispCodeptr;
+void sendTextboxValues (void) {
+	breakPointVal = strtol(textboxlist[0].text, NULL, 16);
+	emuSendCmd(EMUCMD_BREAKPOINT, breakPointVal);
+	memPaneAddr = strtol(textboxlist[1].text, NULL, 16);
+	emuSendCmd(EMUCMD_MEMADDR, memPaneAddr);
+}
+
+void sendRTKey (SDL_Scancode scancode, int pressed) {
+	uint8_t code = rtScanCodes[scancode];
+	if (!code) {return;}
+	if (ioHostKey(code, pressed)) {
+		printf("Keyboard buffer full, dropped key.\n");
+	}
+	emuSendCmd(EMUCMD_HOSTKEY, 0);
 }
 
 void render_GPRs(void) {
 	char string[12];
 	for (int i=0; i < 16; i++) {
-		sprintf(string, "0x%08X", *(GPRlocptr + i));
-		generateTextTexture(&textlist[19+i], string, textColor, 0, 0, UPDATETEXT);
+		sprintf(string, "0x%08X", snap.GPR[i]);
+		generateTextTexture(&textlist[19+i], string, 0, 0, UPDATETEXT);
 	}
 }
 
+// Hex dump or one instruction per row, all from the snapshot's bytes
 void render_Mem_Panel(void) {
-	char string[12];
-	for (int i=0; i < 24; i++) {
-		if (memaddrval > 0x00FFFFE7) {memaddrval = 0x00FFFFE7;}
-		sprintf(string, "0x%08X", memread(memlocptr, (memaddrval + (i*4)), WIDTH_WORD));
-		generateTextTexture(&textlist[36+i], string, textColor, 0, 0, UPDATETEXT);
+	char string[TEXTBOXMAX];
+	char text[DISASMMAX];
+	uint8_t *bytes = snap.memBytes;
+	uint32_t offset = 0;
+
+	sprintf(string, "%s %s", snap.memVirt ? "Virt" : "Real", memPaneDisasm ? "Dis" : "Hex");
+	generateTextTexture(&textlist[MEMPANETEXT], string, 0, 0, UPDATETEXT);
+	for (int i=0; i < MEMPANEROWS; i++) {
+		if (memPaneDisasm) {
+			uint32_t inst = (bytes[offset] << 24) | (bytes[offset+1] << 16) | (bytes[offset+2] << 8) | bytes[offset+3];
+			int len = disasm(inst, text, sizeof(text));
+			if (len == 4) {
+				sprintf(string, "%08X  %08X  %s", snap.memAddr + offset, inst, text);
+			} else {
+				sprintf(string, "%08X  %04X      %s", snap.memAddr + offset, inst >> 16, text);
+			}
+			memPaneLen[i] = len;
+		} else {
+			char ascii[9];
+			for (int j=0; j < 8; j++) {
+				ascii[j] = isprint(bytes[offset+j]) ? bytes[offset+j] : '.';
+			}
+			ascii[8] = '\0';
+			sprintf(string, "%08X  %02X%02X %02X%02X %02X%02X %02X%02X  %s", snap.memAddr + offset,
+				bytes[offset], bytes[offset+1], bytes[offset+2], bytes[offset+3],
+				bytes[offset+4], bytes[offset+5], bytes[offset+6], bytes[offset+7], ascii);
+			memPaneLen[i] = 8;
+		}
+		offset += memPaneLen[i];
+		generateTextTexture(&textlist[MEMPANETEXT+1+i], string, 0, 0, UPDATETEXT);
+	}
+}
+
+// Rows going down are the ones on screen, going up we can only step a halfword per row
+void scrollMemPanel (int rows) {
+	char string[TEXTBOXMAX];
+	if (rows > 0) {
+		for (int i=0; i < rows && i < MEMPANEROWS; i++) {
+			memPaneAddr += memPaneLen[i];
+		}
+	} else {
+		memPaneAddr -= (-rows) * (memPaneDisasm ? 2 : 8);
+	}
+	sprintf(string, "%08X", memPaneAddr);
+	generateTextTexture(&textboxlist[1], string, 0, 0, UPDATETEXT);
+	emuSendCmd(EMUCMD_MEMADDR, memPaneAddr);
+}
+
+struct disCacheEntry* disasmCached (uint32_t addr, uint32_t inst) {
+	struct disCacheEntry *entry = &disCache[(addr >> 1) & (DISCACHESIZE - 1)];
+	if (!entry->valid || entry->addr != addr || entry->inst != inst) {
+		entry->addr = addr;
+		entry->inst = inst;
+		entry->len = disasm(inst, entry->text, sizeof(entry->text));
+		entry->valid = 1;
+	}
+	return entry;
+}
+
+uint32_t disPaneInst (uint32_t offset) {
+	uint8_t *bytes = snap.disBytes;
+	if ((offset + 4) > DISPANEBYTES) {return 0;}
+	return (bytes[offset] << 24) | (bytes[offset+1] << 16) | (bytes[offset+2] << 8) | bytes[offset+3];
+}
+
+// Instructions are variable length so we can't decode backwards from IAR.
+// Start from the furthest halfword before it that decodes forward onto IAR.
+void render_Dis_Panel(void) {
+	char string[TEXTBOXMAX];
+	uint32_t start = DISPANEBACK;
+	for (uint32_t back = DISPANEBACK; back > 0; back -= 2) {
+		uint32_t offset = DISPANEBACK - back;
+		while (offset < DISPANEBACK) {
+			offset += instLength(disPaneInst(offset));
+		}
+		if (offset == DISPANEBACK) {
+			start = DISPANEBACK - back;
+			break;
+		}
+	}
+	// Only keep a few rows of context above IAR
+	int above = 0;
+	for (uint32_t offset = start; offset < DISPANEBACK; offset += instLength(disPaneInst(offset))) {above++;}
+	while (above > DISPANECONTEXT) {
+		start += instLength(disPaneInst(start));
+		above--;
+	}
+
+	uint32_t offset = start;
+	for (int i=0; i < DISPANEROWS; i++) {
+		uint32_t addr = snap.disAddr + offset;
+		struct disCacheEntry *entry = disasmCached(addr, disPaneInst(offset));
+		char mark = (offset == DISPANEBACK) ? '>' : ((addr == breakPointVal) ? '*' : ' ');
+		if (entry->len == 4) {
+			sprintf(string, "%c%08X  %08X  %s", mark, addr, entry->inst, entry->text);
+		} else {
+			sprintf(string, "%c%08X  %04X      %s", mark, addr, entry->inst >> 16, entry->text);
+		}
+		generateTextTexture(&textlist[DISPANETEXT+1+i], string, 0, 0, UPDATETEXT);
+		offset += entry->len;
+	}
+}
+
+// MDA attribute byte to atlas variant
+int mdaAttrVariant (uint8_t attr) {
+	if ((attr & 0x77) == 0x70) {return GLYPH_REVERSE;}
+	if ((attr & 0x07) == 0x01) {return (attr & 0x08) ? GLYPH_INTENSE_UNDERLINE : GLYPH_UNDERLINE;}
+	return (attr & 0x08) ? GLYPH_INTENSE : GLYPH_NORMAL;
+}
+
+void render_MDA_Row(int row) {
+	for (int i=0; i < MDA_COLS; i++) {
+		uint16_t cell = (mdalocptr->startAddr + (row * MDA_COLS) + i) & ((MDA_MEMSIZE >> 1) - 1);
+		uint8_t glyph = mdalocptr->videoMem[cell << 1];
+		uint8_t attr = mdalocptr->videoMem[(cell << 1) + 1];
+		if ((attr & 0x77) == 0x00) {
+			// Non-display
+			glyph = 0;
+		} else if ((attr & 0x80) && (mdalocptr->ctrlReg & MDACTRL_Blink) && !mdaBlinkPhase) {
+			glyph = 0;
+		}
+		setGlyphQuad(&mdaVerts[((row * MDA_COLS) + i) * 4], i * CHARW, row * CHARH, glyph, mdaAttrVariant(attr));
 	}
 }
 
+void render_MDA_Cursor(void) {
+	int cell = getMDACursor(mdalocptr);
+	if (cell < 0 || !blinkOn) {return;}
+	if ((mdalocptr->crtcRegs[CRTC_CursorStart] & CURSOR_BlinkMode) == CURSOR_Hidden) {return;}
+	int start = mdalocptr->crtcRegs[CRTC_CursorStart] & CURSOR_ScanLine;
+	int end = mdalocptr->crtcRegs[CRTC_CursorEnd] & CURSOR_ScanLine;
+	if (start > end || start >= MDA_SCANLINES) {return;}
+	if (end >= MDA_SCANLINES) {end = MDA_SCANLINES - 1;}
+	// Scale 14 scan line cursor shape to our character height
+	SDL_Rect cursorRect;
+	cursorRect.x = (cell % MDA_COLS) * CHARW;
+	cursorRect.y = ((cell / MDA_COLS) * CHARH) + ((start * CHARH) / MDA_SCANLINES);
+	cursorRect.w = CHARW;
+	cursorRect.h = (((end + 1) * CHARH) / MDA_SCANLINES) - ((start * CHARH) / MDA_SCANLINES);
+	SDL_SetRenderDrawColor(rend, 0, 200, 0, SDL_ALPHA_OPAQUE);
+	SDL_RenderFillRect(rend, &cursorRect);
+}
+
 void render_MDA(void) {
-	SDL_Rect charRect;
-	charRect.h = CHARH;
-	charRect.w = CHARW;
-	for (int i=0; i < 2000; i++) {
-		charRect.x = (i % 80) * CHARW;
-		charRect.y = (i / 80) * CHARH;
-		SDL_RenderCopy(rend, fontTexture[mdalocptr[(i << 1)]], NULL, &charRect);
+	// Blinking cells need redrawing when the phase changes
+	if (mdaBlinkPhase != blinkOn) {
+		mdaBlinkPhase = blinkOn;
+		mdaRedrawAll = 1;
+	}
+	// Only rebuild rows that changed since last frame
+	for (int i=0; i < MDA_ROWS; i++) {
+		if (mdaRedrawAll || mdaRowSeen[i] != mdalocptr->rowGen[i]) {
+			mdaRowSeen[i] = mdalocptr->rowGen[i];
+			render_MDA_Row(i);
+		}
 	}
+	mdaRedrawAll = 0;
+
+	SDL_RenderGeometry(rend, glyphAtlas, mdaVerts, MDA_COLS*MDA_ROWS*4, mdaIndices, MDA_COLS*MDA_ROWS*6);
+	render_MDA_Cursor();
+	SDL_SetRenderDrawColor(rend, 255, 255, 255, SDL_ALPHA_OPAQUE);
 }
 
 void render_Front_Panel_Code(void) {
 	char string[3];
-	if (*dispCodelocptr == 0xFF) {
+	if (snap.dispCode == 0xFF) {
 		sprintf(string, "  ");
 	} else {
-		sprintf(string, "%02X", *dispCodelocptr);
+		sprintf(string, "%02X", snap.dispCode);
 	}
-	generateTextTexture(&textlist[61], string, textColor, 0, 0, UPDATETEXT);
+	generateTextTexture(&textlist[61], string, 0, 0, UPDATETEXT);
 }
 
-uint32_t getBreakPoint (void) {
-	return iarbreakptval;
+int hudPercent (uint64_t part, uint64_t total) {
+	return total ? (int)((part * 100) / total) : 0;
 }
 
-int getSingleStep (void) {
-	return singlestep;
-}
+void render_Perf_HUD(void) {
+	uint64_t now = SDL_GetTicks64();
+	if ((now - hudTicks) < 1000) {return;}
+	uint64_t elapsed = now - hudTicks;
+	hudTicks = now;
+
+	struct perfSamples samples;
+	perfReadSamples(&samples);
+	uint64_t total = samples.total - hudSamples.total;
+	uint64_t section[PERF_SECTIONS];
+	for (int i=0; i < PERF_SECTIONS; i++) {
+		section[i] = samples.section[i] - hudSamples.section[i];
+	}
+	double mips = (double)(snap.instCount - hudInstCount) / (elapsed * 1000.0);
+	uint64_t hits = snap.tlbHits - hudTLBHits;
+	uint64_t lookups = hits + (snap.tlbMisses - hudTLBMisses);
+
+	char string[TEXTBOXMAX];
+	int len = snprintf(string, sizeof(string), "MIPS:%6.2f  CPU %3d%%  MMU %3d%%  IO %3d%%  Idle %3d%%  GUI %3d%%  ", mips,
+		hudPercent(section[PERF_CPU], total), hudPercent(section[PERF_MMU], total), hudPercent(section[PERF_IO], total),
+		hudPercent(section[PERF_IDLE], total), hudPercent(samples.gui - hudSamples.gui, total));
+	if (lookups) {
+		snprintf(string + len, sizeof(string) - len, "TLB %5.1f%%", (hits * 100.0) / lookups);
+	} else {
+		snprintf(string + len, sizeof(string) - len, "TLB   n/a");
+	}
+	generateTextTexture(&textlist[62], string, 0, 0, UPDATETEXT);
+
+	// Most run opcodes (first byte) over the last second
+	uint32_t delta[256];
+	uint64_t ops = 0;
+	for (int i=0; i < 256; i++) {
+		delta[i] = snap.instCounter[i] - hudInstCounter[i];
+		ops += delta[i];
+	}
+	len = snprintf(string, sizeof(string), "Top ops:");
+	for (int n=0; n < HUDTOPOPS; n++) {
+		int top = -1;
+		for (int i=0; i < 256; i++) {
+			if (delta[i] && (top < 0 || delta[i] > delta[top])) {top = i;}
+		}
+		if (top < 0) {break;}
+		len += snprintf(string + len, sizeof(string) - len, "  %02X %3d%%", top, hudPercent(delta[top], ops));
+		delta[top] = 0;
+	}
+	generateTextTexture(&textlist[63], string, 0, 0, UPDATETEXT);
+
+	// Host cycles per emulated second by subsystem
+	if (hostprofEnabled()) {
+		struct hostprofCounts counts;
+		hostprofRead(&counts);
+		double seconds = (double)(snap.emuTime - hudEmuTime) / (NS_PER_MS * 1000.0);
+		// Scopes on a thread without rdpmc count ticks, marked t
+		len = snprintf(string, sizeof(string), "Host Mcyc/emu s:");
+		for (int s=0; s < HPROF_SCOPES; s++) {
+			uint64_t cycles = counts.count[s][HPROF_CYCLES] - hudHostCounts.count[s][HPROF_CYCLES];
+			len += snprintf(string + len, sizeof(string) - len, " %s %.1f%s", hostprofNames[s], (seconds > 0) ? cycles / seconds / 1e6 : 0.0, counts.tsc[s] ? "t" : "");
+		}
+		generateTextTexture(&textlist[36], string, 0, 0, UPDATETEXT);
+		hudHostCounts = counts;
+	}
 
-int getContinueBtn (void) {
-	return continuebtn;
+	hudSamples = samples;
+	hudInstCount = snap.instCount;
+	memcpy(hudInstCounter, snap.instCounter, sizeof(hudInstCounter));
+	hudTLBHits = snap.tlbHits;
+	hudTLBMisses = snap.tlbMisses;
+	hudEmuTime = snap.emuTime;
 }
 
 int gui_update (void) {
+	perfSetGUIBusy(1);
 	SDL_SetRenderDrawColor(rend, 0, 0, 0, SDL_ALPHA_OPAQUE);
 	SDL_RenderClear(rend);
 	SDL_SetRenderDrawColor(rend, 255, 255, 255, SDL_ALPHA_OPAQUE);
@@ -322,14 +638,19 @@ int gui_update (void) {
 		if (blinkOn) {blinkOn = 0;} else {blinkOn = 1;}
 	}
 
+	emuReadSnapshot(&snap);
+	emuRequestSnapshot();
+
 	char string[12];
-	sprintf(string, "0x%08X", SCRlocptr->IAR);
-	generateTextTexture(&textlist[1], string, textColor, 0, 0, UPDATETEXT);
+	sprintf(string, "0x%08X", snap.SCR.IAR);
+	generateTextTexture(&textlist[1], string, 0, 0, UPDATETEXT);
 
 	render_GPRs();
 	render_Mem_Panel();
+	render_Dis_Panel();
 	render_MDA();
 	render_Front_Panel_Code();
+	render_Perf_HUD();
 
 	SDL_Event event;
 	while (SDL_PollEvent(&event)) {
@@ -341,43 +662,62 @@ int gui_update (void) {
 				buttons = SDL_GetMouseState(&x, &y);
 				if (buttons & SDL_BUTTON_LMASK) {
 					for (int i=0; i<TEXTMAX; i++) {
-						if (textboxlist[i].texture != NULL) {
+						if (textboxlist[i].used) {
 							if (x > textboxlist[i].rect.x && x < (textboxlist[i].rect.x + textboxlist[i].rect.w) && y > textboxlist[i].rect.y && y < (textboxlist[i].rect.y + textboxlist[i].rect.h)) {
 								selectedbox = i;
 								break;
 							} else {
 								selectedbox = TEXTMAX+1;
 							}
-						} else {
-							break;
 						}
 					}
 					
 					for (int i=0; i<TEXTMAX; i++) {
-						if (buttonlist[i].texture != NULL) {
+						if (buttonlist[i].used) {
 							if (x > buttonlist[i].rect.x && x < (buttonlist[i].rect.x + buttonlist[i].rect.w) && y > buttonlist[i].rect.y && y < (buttonlist[i].rect.y + buttonlist[i].rect.h)) {
 								switch (i) {
 									case 0:
-										continuebtn++;
+										emuSendCmd(EMUCMD_CONTHALT, 0);
 										break;
 									case 1:
-										singlestep++;
+										emuSendCmd(EMUCMD_STEP, 0);
+										break;
+									case 2:
+										memPaneDisasm = !memPaneDisasm;
+										break;
+									case 3:
+										memPaneVirt = !memPaneVirt;
+										emuSendCmd(EMUCMD_MEMVIRT, memPaneVirt);
+										break;
+									case 4:
+										emuSendCmd(EMUCMD_FLIGHTREC, 0);
 										break;
 									default:
 										break;
 								}
 							}
-						} else {
-							break;
 						}
 					}
 				}
 				break;
+			case SDL_MOUSEWHEEL:
+				SDL_GetMouseState(&x, &y);
+				if (x > PANELW && event.wheel.y) {
+					scrollMemPanel(-event.wheel.y * MEMPANESCROLL);
+				}
+				break;
 			case SDL_KEYDOWN:
 				if (selectedbox != TEXTMAX+1) {
 					updateTextTexture(&textboxlist[selectedbox], event.key.keysym.sym);
-					iarbreakptval = strtol(textboxlist[0].text, NULL, 16);
-					memaddrval = strtol(textboxlist[1].text, NULL, 16);
+					sendTextboxValues();
+				} else {
+					// No textbox selected, keys go to the RT keyboard
+					sendRTKey(event.key.keysym.scancode, 1);
+				}
+			break;
+			case SDL_KEYUP:
+				if (selectedbox == TEXTMAX+1) {
+					sendRTKey(event.key.keysym.scancode, 0);
 				}
 			break;
 		}
@@ -386,6 +726,7 @@ int gui_update (void) {
 	render_interface();
 
 	SDL_RenderPresent(rend);
+	perfSetGUIBusy(0);
 	return ret;
 }
 /*
@@ -400,4 +741,5 @@ int main (void) {
 	gui_close();
 	return 0;
 }
-*/
\ No newline at end of file
+*/
+#endif
@@ -12,19 +12,61 @@
 #include "romp.h"
 #include "mmu.h"
 #include "memory.h"
+#include "iocc.h"
+#include "mda.h"
+#include "emu.h"
+#include "perf.h"
+#include "disasm.h"
+#include "hostprof.h"
+#include "events.h"
 
 #define CHARSINFONT 256
 #define CHARH 18
 #define CHARW 10
-#define TEXTMAX 64
+#define TEXTMAX 128
 #define TEXTBOXMAX 256
 
+// Glyph atlas, 16x16 glyphs per attribute variant stacked vertically
+#define ATLASCOLS 16
+#define ATLASROWS (CHARSINFONT / ATLASCOLS)
+#define GLYPH_NORMAL						0
+#define GLYPH_INTENSE						1
+#define GLYPH_UNDERLINE					2
+#define GLYPH_INTENSE_UNDERLINE	3
+#define GLYPH_REVERSE						4
+#define GLYPH_VARIANTS					5
+
 #define TEXT 0
 #define TEXTBOX 1
 #define UPDATETEXT 2
 
+#define PANELCHARMAX 4096
+
+#define PANELW 800
+#define MEMPANECOLS 48
+#define MEMPANEX (PANELW + CHARW)
+#define MEMPANETEXT 64		// First textlist entry of the memory pane
+#define MEMPANESCROLL 3	// Rows per mouse wheel notch
+#define DISPANETEXT (MEMPANETEXT + MEMPANEROWS + 1)	// Header then rows
+#define DISPANEY (CHARH*(MEMPANEROWS + 1))
+#define DISPANECONTEXT 4	// Rows shown above IAR when we can find them
+#define DISCACHESIZE 1024	// Decoded lines, must be a power of two
+#define WINDOWW (MEMPANEX + (CHARW*(MEMPANECOLS+1)))
+#define WINDOWH (CHARH*36)
+#define HUDTOPOPS 5	// Opcodes shown in the perf HUD
+
+// Disassembled line, keyed by address and instruction word
+struct disCacheEntry {
+	uint32_t addr;
+	uint32_t inst;
+	uint8_t valid;
+	uint8_t len;
+	char text[DISASMMAX];
+};
+
+// Fixed width text drawn from the glyph atlas
 struct Text_Texture {
-	SDL_Texture	*texture;
+	int used;
 	SDL_Rect rect;
 	SDL_Rect sqrrect;
 	char text[TEXTBOXMAX];
@@ -32,17 +74,17 @@ struct Text_Texture {
 
 void gui_init (void);
 void gui_close (void);
-void generateTextTexture (struct Text_Texture *textureptr, const char *text, SDL_Color textColor, int x, int y, int textbox);
+void generateTextTexture (struct Text_Texture *textureptr, const char *text, int x, int y, int textbox);
 void updateTextTexture (struct Text_Texture *textureptr, char character);
-void render_all_text (struct Text_Texture *texturelistptr);
+void render_panel_text (void);
 void render_all_textboxes (struct Text_Texture *texturelistptr);
 void render_all_buttons (struct Text_Texture *texturelistptr);
 void setup_text_textures (void);
-void romp_pointers(uint32_t *GPRptr, union SCRs *SCRptr, uint8_t* memptr, uint8_t* mdaptr, uint8_t* dispCodeptr);
+void sendTextboxValues (void);
 void render_GPRs(void);
-uint32_t getBreakPoint (void);
-int getSingleStep (void);
-int getContinueBtn (void);
+void render_Mem_Panel(void);
+void scrollMemPanel (int rows);
+void render_Dis_Panel(void);
 int gui_update (void);
 
 #endif
\ No newline at end of file
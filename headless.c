@@ -0,0 +1,145 @@
+// Headless Batch Mode
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include "headless.h"
+#include "romp.h"
+#include "emu.h"
+#include "screenrec.h"
+#include "shmexport.h"
+#include "logfac.h"
+#include "trace.h"
+#include "triggers.h"
+#include "flightrec.h"
+#include "profile.h"
+#include "coverage.h"
+#include "timeline.h"
+#include "perf.h"
+#include "symbols.h"
+#include "hostprof.h"
+#include "options.h"
+
+volatile sig_atomic_t flightrecRequest = 0;
+
+void dumpMDAText (FILE* out, struct structmda* mdaptr) {
+	char line[MDA_COLS+1];
+	fprintf(out, "--- MDA screen at inst %llu ---\n", (unsigned long long)getInstCount());
+	for (int row=0; row < MDA_ROWS; row++) {
+		int len = 0;
+		for (int col=0; col < MDA_COLS; col++) {
+			uint16_t cell = (mdaptr->startAddr + (row * MDA_COLS) + col) & ((MDA_MEMSIZE >> 1) - 1);
+			uint8_t glyph = mdaptr->videoMem[cell << 1];
+			uint8_t attr = mdaptr->videoMem[(cell << 1) + 1];
+			if ((attr & 0x77) == 0x00 || glyph == 0x00) {
+				line[col] = ' ';
+			} else if (glyph < 0x20 || glyph > 0x7E) {
+				line[col] = '.';
+			} else {
+				line[col] = glyph;
+			}
+			if (line[col] != ' ') {len = col + 1;}
+		}
+		line[len] = '\0';
+		fprintf(out, "%s\n", line);
+	}
+	fflush(out);
+}
+
+void headlessSignal (int sig) {
+	(void)sig;
+	flightrecRequest = 1;
+}
+
+const struct optionHelp headlessHelp[] = {
+	{'n', "instructions", "Stop after this many instructions (default: run forever)", 0},
+	{'o', "screen.txt", "Write MDA screens and display codes here (default: stdout)", 0},
+	{0}
+};
+
+int headlessMain (int argc, char *argv[], struct structmda* mdaptr, uint8_t* dispCodeptr) {
+	uint64_t maxInsts = 0;
+	FILE *out = stdout;
+	int opt;
+	while ((opt = getopt(argc, argv, "n:o:" COMMONOPTS)) != -1) {
+		switch (opt) {
+			case 'n':
+				maxInsts = strtoull(optarg, NULL, 0);
+				break;
+			case 'o':
+				out = fopen(optarg, "w");
+				if (!out) {
+					fprintf(stderr, "Error opening %s\n", optarg);
+					return 1;
+				}
+				break;
+			default:
+				switch (parseCommonOpt(opt, optarg, mdaptr, dispCodeptr)) {
+					case 0:
+						break;
+					case -1:
+						optionsUsage(argv[0], headlessHelp);
+						fprintf(stderr, "SIGUSR1 writes the last %d instructions to %s\n", FLIGHTRECSIZE, FLIGHTRECFILE);
+						return 1;
+					default:
+						return 1;
+				}
+		}
+	}
+	// The GUI always runs it, here only the guest sampler needs it
+	if (perfSamplingGuest() && perfStart()) {return 1;}
+
+	signal(SIGUSR1, headlessSignal);
+	uint8_t prevDispCode = *dispCodeptr;
+	uint32_t prevScreenGen = mdaptr->screenGen;
+	uint64_t nextFrame = HEADLESS_FRAMETIME;
+	while ((!maxInsts || getInstCount() < maxInsts) && !emuQuitSignal) {
+		if (getWaitState()) {
+			// Nothing to wait for, nothing will ever happen
+			if (emuWaitIdle(0)) {
+				fprintf(out, "WAIT with no device events pending at inst %llu, stopping\n", (unsigned long long)getInstCount());
+				break;
+			}
+		} else {
+			emuStep();
+		}
+		if (flightrecRequest) {
+			flightrecRequest = 0;
+			flightrecDump("Requested", 0);
+		}
+		if (*dispCodeptr != prevDispCode) {
+			prevDispCode = *dispCodeptr;
+			if (prevDispCode == 0xFF) {
+				fprintf(out, "DISP: blank at inst %llu\n", (unsigned long long)getInstCount());
+			} else {
+				fprintf(out, "DISP: %02X at inst %llu\n", prevDispCode, (unsigned long long)getInstCount());
+			}
+			fflush(out);
+		}
+		if (getEmuTime() >= nextFrame) {
+			nextFrame = getEmuTime() + HEADLESS_FRAMETIME;
+			if (mdaptr->screenGen != prevScreenGen) {
+				prevScreenGen = mdaptr->screenGen;
+				dumpMDAText(out, mdaptr);
+			}
+		}
+	}
+	if (mdaptr->screenGen != prevScreenGen) {
+		dumpMDAText(out, mdaptr);
+	}
+	screenrecStop();
+	shmexportStop();
+	traceStop();
+	profileStop();
+	coverageStop();
+	timelineStop();
+	perfStop();
+	hostprofSummary(getEmuTime());
+
+	if (out != stdout) {
+		fclose(out);
+	}
+	return 0;
+}
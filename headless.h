@@ -0,0 +1,15 @@
+// Headless Batch Mode
+#ifndef _HEADLESS
+#define _HEADLESS
+#include <stdio.h>
+#include <stdint.h>
+#include "defs.h"
+#include "mda.h"
+#include "events.h"
+
+// Check the MDA for changes once per emulated 60Hz frame
+#define HEADLESS_FRAMETIME	(16667 * NS_PER_US)
+
+int headlessMain (int argc, char *argv[], struct structmda* mdaptr, uint8_t* dispCodeptr);
+
+#endif
@@ -0,0 +1,178 @@
+// Host Subsystem Profiling
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "hostprof.h"
+#include "events.h"
+
+const char *hostprofNames[HPROF_SCOPES] = {"decode", "mmu", "ecc", "ioaccess", "iocycle", "gui"};
+
+#ifdef HOSTPROF
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// Each scope is only ever entered from one thread, so totals have one writer
+_Atomic uint64_t hprofCalls[HPROF_SCOPES];
+_Atomic uint64_t hprofCount[HPROF_SCOPES][HPROF_EVENTS];
+_Atomic uint8_t hprofTsc[HPROF_SCOPES];	// The thread running the scope can't rdpmc
+
+struct hprofFrame {
+	int scope;
+	uint64_t start[HPROF_EVENTS];
+	uint64_t child[HPROF_EVENTS];
+};
+
+// Per thread, the emulation and GUI threads each get their own counters
+_Thread_local int hprofSetup = 0;
+_Thread_local int hprofRdpmc = 0;
+_Thread_local struct perf_event_mmap_page *hprofPage[HPROF_EVENTS];
+_Thread_local struct hprofFrame hprofStack[HPROF_DEPTH];
+_Thread_local int hprofDepth = 0;
+
+const uint64_t hprofConfig[HPROF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+
+void hprofOpen (void) {
+	hprofSetup = 1;
+	hprofRdpmc = 1;
+	for (int i=0; i < HPROF_EVENTS; i++) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = hprofConfig[i];
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		hprofPage[i] = (fd < 0) ? MAP_FAILED : mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, fd, 0);
+		if (fd >= 0) {close(fd);}
+		if (hprofPage[i] == MAP_FAILED || !hprofPage[i]->cap_user_rdpmc) {hprofRdpmc = 0;}
+	}
+}
+
+uint64_t hprofTicks (void) {
+#if defined(__x86_64__) || defined(__i386__)
+	uint32_t lo, hi;
+	__asm__ volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64_t)hi << 32) | lo;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+#endif
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Self monitoring read, see perf_event_open(2)
+uint64_t hprofPMC (struct perf_event_mmap_page* page) {
+	uint32_t seq, idx;
+	uint64_t count;
+	do {
+		seq = page->lock;
+		__asm__ volatile ("" ::: "memory");
+		idx = page->index;
+		count = page->offset;
+		if (idx) {
+			uint32_t lo, hi;
+			__asm__ volatile ("rdpmc" : "=a" (lo), "=d" (hi) : "c" (idx - 1));
+			int64_t pmc = ((uint64_t)hi << 32) | lo;
+			pmc <<= 64 - page->pmc_width;
+			pmc >>= 64 - page->pmc_width;
+			count += pmc;
+		}
+		__asm__ volatile ("" ::: "memory");
+	} while (page->lock != seq);
+	return count;
+}
+#endif
+
+void hprofReadNow (uint64_t* now) {
+#if defined(__x86_64__) || defined(__i386__)
+	if (hprofRdpmc) {
+		for (int i=0; i < HPROF_EVENTS; i++) {now[i] = hprofPMC(hprofPage[i]);}
+		return;
+	}
+#endif
+	now[HPROF_CYCLES] = hprofTicks();
+	now[HPROF_INSTS] = 0;
+	now[HPROF_MISSES] = 0;
+}
+
+void hostprofEnter (int scope) {
+	if (!hprofSetup) {hprofOpen();}
+	if (hprofDepth >= HPROF_DEPTH) {
+		hprofDepth++;
+		return;
+	}
+	struct hprofFrame *frame = &hprofStack[hprofDepth++];
+	frame->scope = scope;
+	memset(frame->child, 0, sizeof(frame->child));
+	hprofReadNow(frame->start);
+}
+
+void hostprofLeave (int scope) {
+	if (hprofDepth-- > HPROF_DEPTH) {return;}
+	uint64_t now[HPROF_EVENTS];
+	hprofReadNow(now);
+	struct hprofFrame *frame = &hprofStack[hprofDepth];
+	for (int i=0; i < HPROF_EVENTS; i++) {
+		uint64_t delta = now[i] - frame->start[i];
+		uint64_t self = (delta > frame->child[i]) ? delta - frame->child[i] : 0;
+		atomic_store_explicit(&hprofCount[scope][i], atomic_load_explicit(&hprofCount[scope][i], memory_order_relaxed) + self, memory_order_relaxed);
+		if (hprofDepth) {hprofStack[hprofDepth-1].child[i] += delta;}
+	}
+	atomic_store_explicit(&hprofCalls[scope], atomic_load_explicit(&hprofCalls[scope], memory_order_relaxed) + 1, memory_order_relaxed);
+	atomic_store_explicit(&hprofTsc[scope], !hprofRdpmc, memory_order_relaxed);
+}
+
+int hostprofEnabled (void) {
+	return 1;
+}
+
+void hostprofRead (struct hostprofCounts* counts) {
+	for (int s=0; s < HPROF_SCOPES; s++) {
+		counts->tsc[s] = atomic_load_explicit(&hprofTsc[s], memory_order_relaxed);
+		counts->calls[s] = atomic_load_explicit(&hprofCalls[s], memory_order_relaxed);
+		for (int i=0; i < HPROF_EVENTS; i++) {
+			counts->count[s][i] = atomic_load_explicit(&hprofCount[s][i], memory_order_relaxed);
+		}
+	}
+}
+
+#else
+
+int hostprofEnabled (void) {
+	return 0;
+}
+
+void hostprofRead (struct hostprofCounts* counts) {
+	memset(counts, 0, sizeof(*counts));
+}
+
+#endif
+
+// Per emulated second, printed at exit
+void hostprofSummary (uint64_t emuTime) {
+	if (!hostprofEnabled()) {return;}
+	struct hostprofCounts counts;
+	hostprofRead(&counts);
+	double seconds = (double)emuTime / (NS_PER_MS * 1000.0);
+	if (seconds <= 0) {return;}
+	// Source is per thread, pmc is perf_event counters, tsc is rdtsc ticks only
+	printf("Host profile over %.3f emulated seconds, per emulated second:\n", seconds);
+	printf("  %-9s %6s %12s %14s %14s %12s %6s\n", "scope", "source", "calls", "cycles", "instructions", "misses", "IPC");
+	for (int s=0; s < HPROF_SCOPES; s++) {
+		uint64_t *c = counts.count[s];
+		const char *source = !counts.calls[s] ? "-" : (counts.tsc[s] ? "tsc" : "pmc");
+		printf("  %-9s %6s %12.0f %14.0f", hostprofNames[s], source, counts.calls[s] / seconds, c[HPROF_CYCLES] / seconds);
+		if (counts.calls[s] && !counts.tsc[s]) {
+			printf(" %14.0f %12.0f %6.2f", c[HPROF_INSTS] / seconds, c[HPROF_MISSES] / seconds,
+				c[HPROF_CYCLES] ? (double)c[HPROF_INSTS] / c[HPROF_CYCLES] : 0.0);
+		}
+		printf("\n");
+	}
+}
@@ -0,0 +1,50 @@
+// Host Subsystem Profiling
+#ifndef _HOSTPROF
+#define _HOSTPROF
+#include <stdint.h>
+
+// Build with -DHOSTPROF to count host cycles, instructions and cache misses
+// spent in each scope below. Counts are self counts, a scope nested in another
+// is taken out of its parent. Counters come from perf_event_open read with
+// rdpmc where the kernel allows it, otherwise cycles only from rdtsc (or ns
+// from clock_gettime on hosts without it). That's decided per thread, so each
+// scope reports the source of the thread that ran it. Without HOSTPROF the
+// scope macros are empty.
+#define HPROF_DECODE		0	// decode(), less what's below
+#define HPROF_MMU				1	// mmuCycle()
+#define HPROF_ECC				2	// genECC(), checkECC() calls it
+#define HPROF_IOACCESS	3	// ioaccess() and adapter memory windows
+#define HPROF_IOCYCLE		4	// iocycle(), devices and events
+#define HPROF_GUI				5	// gui_update()
+#define HPROF_SCOPES		6
+
+#define HPROF_CYCLES	0
+#define HPROF_INSTS		1
+#define HPROF_MISSES	2
+#define HPROF_EVENTS	3
+
+#define HPROF_DEPTH	16	// Deepest scope nesting
+
+struct hostprofCounts {
+	uint8_t tsc[HPROF_SCOPES];	// Cycles are rdtsc ticks (or ns), not core cycles, and nothing else was counted
+	uint64_t calls[HPROF_SCOPES];
+	uint64_t count[HPROF_SCOPES][HPROF_EVENTS];
+};
+
+#ifdef HOSTPROF
+void hostprofEnter (int scope);
+void hostprofLeave (int scope);
+#define HPROF_ENTER(scope)	hostprofEnter(scope)
+#define HPROF_LEAVE(scope)	hostprofLeave(scope)
+#else
+#define HPROF_ENTER(scope)
+#define HPROF_LEAVE(scope)
+#endif
+
+int hostprofEnabled (void);
+void hostprofRead (struct hostprofCounts* counts);
+void hostprofSummary (uint64_t emuTime);
+
+extern const char *hostprofNames[HPROF_SCOPES];
+
+#endif
@@ -12,6 +12,7 @@
 #include "8259a.h"
 #include "rtc.h"
 #include "mda.h"
+#include "events.h"
 #include "logfac.h"
 
 struct SysBrdConfig sysbrdcnfg;
@@ -28,48 +29,87 @@ struct ioBusStruct ioBus;
 
 uint8_t CSRlocked;
 
+struct ioMemWindow ioMemWindows[8];
+uint8_t ioMemWindowCnt;
+struct ioMemWindow* ioMemPages[IOMEMPAGES];
+
 void ioinit (struct procBusStruct* procBusPointer) {
 	procBusPtr = procBusPointer;
+	eventsinit();
 	//sysbrdcnfg.CSR = 0x220000FF;
 	initkbadpt(&kbAdapter, &ioBus, 0x008400, 0xFFFFF8);
 	initRTC(&sysRTC, &ioBus, 0x008800, 0xFFFFC0);
 	init8237(&dmaCtrl1, &ioBus, 0x008840, 0xFFFFF0);
 	init8237(&dmaCtrl2, &ioBus, 0x008860, 0xFFFFF0);
-	init8259(&intCtrl1, &ioBus, 0x008880, 0xFFFFE0);
-	init8259(&intCtrl2, &ioBus, 0x0088A0, 0xFFFFE0);
+	// Each 8259 INT output drives its own processor level
+	init8259(&intCtrl1, &ioBus, 0x008880, 0xFFFFE0, INTRPT_3_IOChan);
+	init8259(&intCtrl2, &ioBus, 0x0088A0, 0xFFFFE0, INTRPT_4_IOChan);
 	initMDA(&mdaVideo, &ioBus, 0x0003B0, 0xFFFFF0, 0x0B0000, 0xFFF000);
 }
 
-uint8_t* getMDAPtr (void) {
-	return &mdaVideo.videoMem[0];
+// Which adapter decodes a processor I/O address, for traces
+const char* ioDeviceName (uint32_t addr) {
+	if ((addr & 0xFF000000) == IOChanMemMapStartAddr) {return "iomem";}
+	uint32_t ioaddr = addr & 0x00FFFFFF;
+	if ((ioaddr & kbAdapter.ioAddressMask) == kbAdapter.ioAddress) {return "kbadpt";}
+	if ((ioaddr & sysRTC.ioAddressMask) == sysRTC.ioAddress) {return "rtc";}
+	if ((ioaddr & dmaCtrl1.ioAddressMask) == dmaCtrl1.ioAddress) {return "8237 1";}
+	if ((ioaddr & dmaCtrl2.ioAddressMask) == dmaCtrl2.ioAddress) {return "8237 2";}
+	if ((ioaddr & intCtrl1.ioAddressMask) == intCtrl1.ioAddress) {return "8259 1";}
+	if ((ioaddr & intCtrl2.ioAddressMask) == intCtrl2.ioAddress) {return "8259 2";}
+	if ((ioaddr & mdaVideo.ioAddressMask) == mdaVideo.ioAddress) {return "mda";}
+	return "sysbrd";
+}
+
+struct structmda* getMDAPtr (void) {
+	return &mdaVideo;
+}
+
+// Safe to call from the GUI thread, the keyboard adapter drains it.
+int ioHostKey (uint8_t scancode, uint8_t make) {
+	return kbadptHostKey(&kbAdapter, scancode, make);
+}
+
+// Emulation thread only, after ioHostKey() calls. Nothing polls for keys.
+void ioHostKeysPending (void) {
+	kbadptHostKeysPending(&kbAdapter);
+}
+
+// Recompute the 8259 IR inputs when one of their sources may have changed,
+// set8259Lines() does nothing if the lines are the same.
+void updateIntLines (void) {
+	// DIAG reg forces all lines high
+	uint8_t lines = sysbrdcnfg.DIAReg ? 0xFF : 0x00;
+	set8259Lines(&intCtrl1, lines | (kbAdapter.intReq << 5));
+	set8259Lines(&intCtrl2, lines);
+}
+
+void dispatchEvents (void) {
+	int id;
+	while ((id = popDueEvent()) != -1) {
+		switch (id) {
+			case EVENT_KBADPT:
+				eventkbadpt(&kbAdapter);
+				updateIntLines();
+				break;
+			case EVENT_RTC:
+				eventRTC(&sysRTC);
+				kbAdapter.PB = (sysRTC.sqwOut << 3);
+				break;
+		}
+	}
 }
 
 void iocycle (void) {
-	if (sysbrdcnfg.DIAReg) {
-		intCtrl1.intLines = 0xFF;
-		intCtrl2.intLines = 0xFF;
-	} else {
-		intCtrl1.intLines = 0;
-		intCtrl2.intLines = 0;
+	advanceEmuTime(NS_PER_INST);
+	if (getEmuTime() >= nextEventTime()) {
+		dispatchEvents();
 	}
 
 	dmaCtrl1.reset = (sysbrdcnfg.CRRBReg & CRRB_DMACtrl1) >> 3;
 	dmaCtrl2.reset = (sysbrdcnfg.CRRBReg & CRRB_DMACtrl2) >> 4;
-	kbAdapter.reset = (sysbrdcnfg.CRRBReg & CRRB_8051) >> 2;
-	cyclekbadpt(&kbAdapter);
-	intCtrl1.intLines |= (kbAdapter.intReq << 5);
-	cycleRTC(&sysRTC);
-	if (sysRTC.intReq) {
-		procBusPtr->intrpt |= INTRPT_1_RealTimeClock;
-	}
-	kbAdapter.PB = (sysRTC.sqwOut << 3);
 	cycle8237(&dmaCtrl1);
 	cycle8237(&dmaCtrl2);
-	cycle8259(&intCtrl1);
-	cycle8259(&intCtrl2);
-
-	if (intCtrl1.intreq) { procBusPtr->intrpt |= INTRPT_3_IOChan; }
-	if (intCtrl2.intreq) { procBusPtr->intrpt |= INTRPT_4_IOChan; }
 }
 
 void accessSysBrdRegs (void) {
@@ -124,6 +164,8 @@ void accessSysBrdRegs (void) {
 			if (ioBus.rw) {
 				logmsgf(LOGIO, "IO: Write CRRB Reg 0x%04X\n", ioBus.data);
 				sysbrdcnfg.CRRBReg = ioBus.data;
+				setkbadptReset(&kbAdapter, (sysbrdcnfg.CRRBReg & CRRB_8051) >> 2);
+				updateIntLines();
 			} else {
 				ioBus.data = sysbrdcnfg.CRRBReg;
 				logmsgf(LOGIO, "IO: Read CRRB Reg 0x%04X\n", ioBus.data);
@@ -139,6 +181,7 @@ void accessSysBrdRegs (void) {
 			if (ioBus.rw) {
 				logmsgf(LOGIO, "IO: Write DIAG Reg 0x%04X\n", ioBus.data);
 				sysbrdcnfg.DIAReg = ioBus.data & 0x01;
+				updateIntLines();
 			}
 		}
 		if ((ioBus.addr & 0xFFF801) == 0x010000) {
@@ -158,6 +201,7 @@ void accessSysBrdRegs (void) {
 void ioaccessAll (void) {
 	accessSysBrdRegs();
 	accesskbadpt(&kbAdapter);
+	updateIntLines();
 	accessRTC(&sysRTC);
 	access8237(&dmaCtrl1);
 	access8237(&dmaCtrl2);
@@ -190,6 +234,100 @@ void setCSR(uint32_t csrbits) {
 	}
 }
 
+// Adapters register plain memory (video buffers etc) here so the MMU can
+// access it directly instead of going through ioaccess() byte by byte.
+void ioMapMemWindow (uint32_t base, uint32_t size, uint8_t* mem, ioMemHook writeHook, void* ctx) {
+	if (ioMemWindowCnt >= (sizeof(ioMemWindows) / sizeof(ioMemWindows[0]))) {
+		logmsgf(LOGIO, "IO: Error too many memory windows.\n");
+		return;
+	}
+	if ((base | size) & ((1 << IOMEMPAGESHIFT) - 1)) {
+		logmsgf(LOGIO, "IO: Error memory window 0x%06X size 0x%06X not page aligned.\n", base, size);
+		return;
+	}
+	struct ioMemWindow* win = &ioMemWindows[ioMemWindowCnt++];
+	win->mem = mem;
+	win->base = base & 0x00FFFFFF;
+	win->size = size;
+	win->writeHook = writeHook;
+	win->ctx = ctx;
+	for (uint32_t page = (win->base >> IOMEMPAGESHIFT); page < ((win->base + size) >> IOMEMPAGESHIFT); page++) {
+		ioMemPages[page] = win;
+	}
+}
+
+// Fast path for I/O channel memory map accesses. Returns 0 if the access
+// isn't to a registered window and has to go through ioaccess().
+// Byte order matches ioaccess(), the I/O channel is little endian within
+// each halfword.
+int ioMemAccess (void) {
+	// Let ioaccess() deal with (and log) privilege errors
+	if (procBusPtr->priv && !(sysbrdcnfg.CtrlRegCCR & CCR_MemMapPrivAcc)) {return 0;}
+
+	uint32_t addr = procBusPtr->addr & 0x00FFFFFF;
+	struct ioMemWindow* win = ioMemPages[addr >> IOMEMPAGESHIFT];
+	if (win == NULL) {return 0;}
+
+	uint32_t offset = addr - win->base;
+	uint8_t len;
+	switch (procBusPtr->width) {
+		case WIDTH_BYTE:
+			len = 1;
+			break;
+		case WIDTH_HALFWORD:
+			offset &= ~0x1;
+			len = 2;
+			break;
+		case WIDTH_WORD:
+			offset &= ~0x3;
+			len = 4;
+			break;
+		default:
+			return 0;
+	}
+	if ((offset + len) > win->size) {return 0;}
+
+	uint8_t* mem = &win->mem[offset];
+	uint32_t data = procBusPtr->data;
+	if (procBusPtr->rw == RW_STORE) {
+		uint8_t bytes[4];
+		switch (len) {
+			case 1:
+				bytes[0] = data;
+				break;
+			case 2:
+				bytes[0] = data;
+				bytes[1] = data >> 8;
+				break;
+			case 4:
+				bytes[0] = data >> 16;
+				bytes[1] = data >> 24;
+				bytes[2] = data;
+				bytes[3] = data >> 8;
+				break;
+		}
+		if (memcmp(mem, bytes, len)) {
+			memcpy(mem, bytes, len);
+			if (win->writeHook != NULL) {
+				win->writeHook(win->ctx, offset, len);
+			}
+		}
+	} else {
+		switch (len) {
+			case 1:
+				procBusPtr->data = mem[0];
+				break;
+			case 2:
+				procBusPtr->data = mem[0] | (mem[1] << 8);
+				break;
+			case 4:
+				procBusPtr->data = (mem[0] << 16) | ((uint32_t)mem[1] << 24) | mem[2] | (mem[3] << 8);
+				break;
+		}
+	}
+	return 1;
+}
+
 void ioaccess (void) {
 	if ((procBusPtr->addr & 0xFF000000) == IOChanIOMapStartAddr) {
 		ioBus.io = 1;
@@ -4,10 +4,30 @@
 
 #define SYSBRDCNFGSIZE 262143
 
+// Host backed adapter memory in the I/O channel memory map, 4K pages
+#define IOMEMPAGESHIFT	12
+#define IOMEMPAGES			(0x01000000 >> IOMEMPAGESHIFT)
+
+// Called after a direct write changed window memory
+typedef void (*ioMemHook)(void* ctx, uint32_t offset, uint8_t len);
+
+struct ioMemWindow {
+	uint8_t* mem;				// Host memory backing the window
+	uint32_t base;			// I/O channel memory address of mem[0]
+	uint32_t size;
+	ioMemHook writeHook;	// NULL if the adapter doesn't care about writes
+	void* ctx;
+};
+
 void ioinit (struct procBusStruct* procBusPointer);
 void iocycle (void);
 void ioaccess (void);
-uint8_t* getMDAPtr (void);
+void ioMapMemWindow (uint32_t base, uint32_t size, uint8_t* mem, ioMemHook writeHook, void* ctx);
+int ioMemAccess (void);
+const char* ioDeviceName (uint32_t addr);
+struct structmda* getMDAPtr (void);
+int ioHostKey (uint8_t scancode, uint8_t make);
+void ioHostKeysPending (void);
 // IO Bus
 struct ioBusStruct {
 	uint32_t addr;	// Address for access (24-bit)
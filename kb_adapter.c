@@ -8,10 +8,13 @@
 #include "kb_adapter.h"
 #include "iocc.h"
 #include "mmu.h"
+#include "events.h"
 #include "logfac.h"
 
 struct ioBusStruct* ioBusPtr;
 
+void schedulekbadpt (struct structkbadpt* currkbadpt);
+
 void initSharedRam (struct structkbadpt* currkbadpt) {
 	currkbadpt->sharedRam[0x00] = 0xFA; // Keyboard ack byte
 	currkbadpt->sharedRam[0x01] = 0x00; // Pending speaker durration ticks
@@ -52,7 +55,8 @@ void initkbadpt (struct structkbadpt* currkbadpt, struct ioBusStruct* ioBusPoint
 	currkbadpt->ioAddressMask = ioaddrMask;
 	currkbadpt->irqEn = 0;
 	currkbadpt->intReq = 0;
-	currkbadpt->initReq = RESET_Delay;
+	currkbadpt->state = KBSTATE_RESET;
+	ringbufInit(&currkbadpt->hostKeys, currkbadpt->hostKeyBuf, HOSTKEYMAX);
 	ioBusPtr = ioBusPointer;
 }
 
@@ -72,6 +76,7 @@ void writekbadpt (struct structkbadpt* currkbadpt) {
 				currkbadpt->PA = (ioBusPtr->data & 0xFF00) >> 8;
 				currkbadpt->PC &= ~PC_PAOutBufEmpty;
 				logmsgf(LOGKBADPT, "KBADPT: Write PA 0x%04X\n", ioBusPtr->data);
+				schedulekbadpt(currkbadpt);
 			} else {
 				logmsgf(LOGKBADPT, "KBADPT: Error write PA attempted when PA Out Buf is full.\n");
 			}
@@ -98,7 +103,9 @@ void readkbadpt (struct structkbadpt* currkbadpt) {
 			if (!(currkbadpt->PC & PC_PAInBufFull)) {logmsgf(LOGKBADPT, "KBADPT: Error Read from PA when data not valid.\n");}
 			ioBusPtr->data = currkbadpt->PA;
 			currkbadpt->PC &= ~(PC_IntReq | PC_PAInBufFull);
+			currkbadpt->intReq = 0;
 			logmsgf(LOGKBADPT, "KBADPT: Read from PA 0x%02X\n", ioBusPtr->data);
+			schedulekbadpt(currkbadpt);
 			break;
 		case 0x5:
 			ioBusPtr->data = currkbadpt->PB;
@@ -139,71 +146,313 @@ void setReturnVals (struct structkbadpt* currkbadpt, uint8_t valPA, uint8_t intI
 }
 
 int circBufPush (struct circ_buf* buf, uint8_t data) {
-	uint8_t next;
-	next = buf->head + 1;
-	if (next >= BUFMAX) {next = 0;}
-	if (next == buf->tail) {return -1;}
+	if ((uint8_t)(buf->head - buf->tail) >= BUFMAX) {return -1;}
 
-	buf->buffer[buf->head] = data;
-	buf->head = next;
+	buf->buffer[buf->head & (BUFMAX - 1)] = data;
+	buf->head++;
 	return 0;
 }
 
 int circBufPop(struct circ_buf* buf, uint8_t *data)
 {
-	uint8_t next;
 	if (buf->head == buf->tail) {return -1;}
-	next = buf->tail + 1;
-	if(next >= BUFMAX) {next = 0;}
 
-	*data = buf->buffer[buf->tail];
-	buf->tail = next;
+	*data = buf->buffer[buf->tail & (BUFMAX - 1)];
+	buf->tail++;
 	return 0;
 }
 
 uint8_t circBufGetLen(struct circ_buf* buf) {
-	uint8_t next;
-	uint8_t length;
-	if (buf->head == buf->tail) {return 0;}
-	next = buf->tail + 1;
-	if(next >= BUFMAX) {next = 0;}
-	length++;
-	while (next != buf->head) {
-		next++;
-		if(next >= BUFMAX) {next = 0;}
-		length++;
-	}
-	return length;
+	return buf->head - buf->tail;
 }
 
-void cyclekbadpt (struct structkbadpt* currkbadpt) {
-	// This cycle acts like the 8051 running.
-	if (!currkbadpt->reset) {
-		currkbadpt->irqEn = 0;
-		currkbadpt->intReq = 0;
-		currkbadpt->initReq = RESET_Delay;
-		return;
-	}
-	
-	if (currkbadpt->initReq > 1 && currkbadpt->initReq <= RESET_Delay) {
-		// Delay some to simulate 8051 initializing, may not be needed...
-		currkbadpt->initReq--;
-		return;
-	} else if (currkbadpt->initReq == 1) {
-		logmsgf(LOGKBADPT, "KBADPT: Initialized after reset released\n");
-		initSharedRam(currkbadpt);
-		setReturnVals(currkbadpt, 0xAE, INTID_8051SelfTest);
-		currkbadpt->initReq--;
-		return;
+// Called from the host (GUI) side only. Set 3 scan codes, a break is queued
+// as the break code (0xF0) then the make code. Returns -1 if the buffer is full.
+int kbadptHostKey (struct structkbadpt* currkbadpt, uint8_t scancode, uint8_t make) {
+	uint8_t bytes[2] = {0xF0, scancode};
+	if (make) {
+		return ringbufWrite(&currkbadpt->hostKeys, &bytes[1], 1);
 	}
+	return ringbufWrite(&currkbadpt->hostKeys, bytes, 2);
+}
 
-	//if (currkbadpt->irqEn && (currkbadpt->PC & PC_IntReq)) {
-		if (currkbadpt->PC & PC_IntReq) {
-		currkbadpt->intReq = 1;
+void processkbadptCmd (struct structkbadpt* currkbadpt) {
+	currkbadpt->PC |= PC_PAOutBufEmpty;
+	currkbadpt->PC &= ~PC_IntReq;
+	currkbadpt->intReq = 0;
+	if (currkbadpt->cmdReg & 0xE0) {logmsgf(LOGKBADPT, "KBADPT: Diag CMD bits not zero CMD:0x%02X PA:0x%02X\n", currkbadpt->cmdReg, currkbadpt->PA);}
+	if (currkbadpt->cmdReg == 0) {
+		// Extended commands pg. 5-99
+		if (currkbadpt->PA >= 0x00 && currkbadpt->PA <= 0x1F) {
+			// Read shared ram
+			uint8_t offset = currkbadpt->PA;
+			setReturnVals(currkbadpt, currkbadpt->sharedRam[offset], INTID_RetReqByte);
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD read ram 0x%02X: 0x%02X\n", offset, currkbadpt->PA);
+		} else if (currkbadpt->PA >= 0x20 && currkbadpt->PA <= 0x2F) {
+			// Reset mode bit
+			if (!(currkbadpt->PA & 0x08)) {
+				logmsgf(LOGKBADPT, "KBADPT: ExtCMD reset mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x10]);
+				currkbadpt->sharedRam[0x10] &= ~(0x01 << (currkbadpt->PA & 0x07));
+				logmsgf(LOGKBADPT, "KBADPT:                          0x%02X\n", currkbadpt->sharedRam[0x10]);
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				if (currkbadpt->PA == 11) {
+					if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
+						logmsgf(LOGKBADPT, "KBADPT: ExtCMD reset mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x11]);
+						currkbadpt->sharedRam[0x11] &= ~(0x01 << (currkbadpt->PA & 0x07));
+						logmsgf(LOGKBADPT, "KBADPT:                          0x%02X\n", currkbadpt->sharedRam[0x11]);
+						setReturnVals(currkbadpt, 0x00, INTID_Info);
+					} else {
+						logmsgf(LOGKBADPT, "KBADPT: Error can't disable keyboard when not in Diag mode\n");
+						setReturnVals(currkbadpt, 0x51, INTID_Info);
+					}
+				} else {
+					currkbadpt->sharedRam[0x11] &= ~(0x01 << (currkbadpt->PA & 0x07));
+					setReturnVals(currkbadpt, 0x00, INTID_Info);
+				}
+			}
+		} else if (currkbadpt->PA >= 0x30 && currkbadpt->PA <= 0x3F) {
+			// Set mode bit
+			if (!(currkbadpt->PA & 0x08)) {
+				logmsgf(LOGKBADPT, "KBADPT: ExtCMD set mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x10]);
+				currkbadpt->sharedRam[0x10] |= 0x01 << (currkbadpt->PA & 0x07);
+				logmsgf(LOGKBADPT, "KBADPT:                        0x%02X\n", currkbadpt->sharedRam[0x10]);
+			} else {
+				logmsgf(LOGKBADPT, "KBADPT: ExtCMD set mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x11]);
+				currkbadpt->sharedRam[0x11] |= 0x01 << (currkbadpt->PA & 0x07);
+				logmsgf(LOGKBADPT, "KBADPT:                        0x%02X\n", currkbadpt->sharedRam[0x11]);
+			}
+			setReturnVals(currkbadpt, 0x00, INTID_Info);
+		} else if (currkbadpt->PA >= 0x40 && currkbadpt->PA <= 0x43) {
+			currkbadpt->sharedRam[0x11] = (currkbadpt->sharedRam[0x11] & ~MODE1_SpkVol) | currkbadpt->PA & MODE1_SpkVol;
+			setReturnVals(currkbadpt, 0x00, INTID_Info);
+		} else if (currkbadpt->PA == 0x44) {
+			// Terminate speaker and reset duration
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD terminate speaker\n");
+			if (currkbadpt->sharedRam[0x12] & (STATUS_SpkTimerBusy | STATUS_TimeoutTimerBsy)) {
+				currkbadpt->sharedRam[0x12] &= ~(STATUS_SpkQueueFull | STATUS_SpkTimerBusy | STATUS_TimeoutTimerBsy);
+				currkbadpt->sharedRam[0x13] = 0x00;
+				currkbadpt->sharedRam[0x14] = 0x00;
+				setReturnVals(currkbadpt, 0x03, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x02, INTID_Info);
+			}
+		} else if (currkbadpt->PA >= 0x50 && currkbadpt->PA <= 0x5F) {
+			// Set scan count for sys attn keystroke sequence
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD set scan count %d\n", currkbadpt->PA & 0x0F);
+			if (currkbadpt->PA >= 0x51 && currkbadpt->PA <= 0x53) {
+				currkbadpt->sharedRam[0x17] = currkbadpt->PA & 0x0F;
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x50, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x60) {
+			// Execute 8051 soft reset
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD 8051 soft reset\n");
+			if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
+				currkbadpt->softResetBytes = 2;
+				setReturnVals(currkbadpt, 0xA0, INTID_8051Error);
+			} else {
+				setReturnVals(currkbadpt, 0x51, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x61) {
+			// Force system reset
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD force system reset\n");
+			if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
+				// TODO: Reset system...
+			} else {
+				setReturnVals(currkbadpt, 0x51, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x62) {
+			// Force system attn interrupt
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD force system attention interrupt\n");
+			if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
+				// TODO: System atten interrupt
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x51, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x62) {
+			// Diagnostic sense keyboard/UART port pins
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD diagnostic sense keyboard/UART\n");
+			if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
+				// Probably don't have to return anything sensible here.
+				setReturnVals(currkbadpt, 0x00, 0x3);
+			} else {
+				setReturnVals(currkbadpt, 0x51, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x80) {
+			// Dump adapter shared 0x00-0x0F
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump adapter shared 0x00-0x0F\n");
+			if (!currkbadpt->ramQueue) {
+				currkbadpt->ramOffset = 0x00;
+				currkbadpt->ramQueue = 0x0F;
+				currkbadpt->ramClear = 0;
+				//setReturnVals(currkbadpt, 0x00, INTID_Info);
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x81) {
+			// Dump adapter shared 0x10-0x1F
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump adapter shared 0x10-0x1F\n");
+			if (!currkbadpt->ramQueue) {
+				currkbadpt->ramOffset = 0x10;
+				currkbadpt->ramQueue = 0x0F;
+				currkbadpt->ramClear = 0;
+				//setReturnVals(currkbadpt, 0x00, INTID_Info);
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x82) {
+			// Dump RAS logs 0x20-0x2B
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump RAS logs 0x20-0x2B\n");
+			if (!currkbadpt->ramQueue) {
+				currkbadpt->ramOffset = 0x20;
+				currkbadpt->ramQueue = 0x0B;
+				currkbadpt->ramClear = 0;
+				//setReturnVals(currkbadpt, 0x00, INTID_Info);
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x83) {
+			// Dump RAS logs 0x20-0x2B with clear
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump RAS logs with clear 0x20-0x2B\n");
+			if (!currkbadpt->ramQueue) {
+				currkbadpt->ramOffset = 0x20;
+				currkbadpt->ramQueue = 0x0B;
+				currkbadpt->ramClear = 1;
+				//setReturnVals(currkbadpt, 0x00, INTID_Info);
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x60, INTID_Info);
+			}
+		} else if (currkbadpt->PA == 0x83) {
+			// Restore initial conditions
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD restore initial conditions\n");
+			initSharedRam(currkbadpt); // Really should only init to 0x1B, but this should be OK
+			setReturnVals(currkbadpt, 0x00, INTID_Info);
+		} else if (currkbadpt->PA >= 0xE0 && currkbadpt->PA <= 0xEF) {
+			// Read 8051 release marker
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD read 8051 release marker\n");
+			setReturnVals(currkbadpt, 0x00, 0x3); // Should return valid data?
+		} else if (currkbadpt->PA >= 0xF0 && currkbadpt->PA <= 0xFF) {
+			// NOP
+			logmsgf(LOGKBADPT, "KBADPT: ExtCMD NOP\n");
+			setReturnVals(currkbadpt, 0x00, INTID_Info);
+		}
 	} else {
-		currkbadpt->intReq = 0;
+		// Non-extended Commands pg. 5-102
+		if ((currkbadpt->cmdReg & 0x1F) == 0x01) {
+			// Write to keyboard
+			logmsgf(LOGKBADPT, "KBADPT: CMD write to keyboard 0x%02X\n", currkbadpt->PA);
+			if (currkbadpt->keylock && (currkbadpt->sharedRam[0x11] & MODE1_HonorKeylock)) {
+				setReturnVals(currkbadpt, 0x42, INTID_Info);
+			} else if (!(currkbadpt->sharedRam[0x11] & MODE1_KBInterfaceEn)) {
+				setReturnVals(currkbadpt, 0x43, INTID_Info);
+			} else if (currkbadpt->PA == currkbadpt->sharedRam[0x03]) {
+				setReturnVals(currkbadpt, 0x44, INTID_Info);
+			} else {
+				// TODO
+				currkbadpt->kbCmdIn = currkbadpt->PA;
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			}
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x02) {
+			// Write to speaker
+			logmsgf(LOGKBADPT, "KBADPT: CMD write to speaker 0x%02X\n", currkbadpt->PA);
+			// TODO
+			setReturnVals(currkbadpt, 0x01, INTID_Info);
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x03) {
+			// Write to UART - control
+			logmsgf(LOGKBADPT, "KBADPT: CMD write to UART control 0x%02X\n", currkbadpt->PA);
+			if (currkbadpt->keylock && (currkbadpt->sharedRam[0x11] & MODE1_HonorKeylock)) {
+				setReturnVals(currkbadpt, 0x42, INTID_Info);
+			} else if (!(currkbadpt->sharedRam[0x11] & MODE1_UARTInterfaceEn)) {
+				setReturnVals(currkbadpt, 0x4B, INTID_Info);
+			} else {
+				currkbadpt->uartCmdIn = currkbadpt->PA;
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			}
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x04) {
+			// Write to UART - query
+			logmsgf(LOGKBADPT, "KBADPT: CMD write to UART query 0x%02X\n", currkbadpt->PA);
+			if (currkbadpt->keylock && (currkbadpt->sharedRam[0x11] & MODE1_HonorKeylock)) {
+				setReturnVals(currkbadpt, 0x42, INTID_Info);
+			} else if (!(currkbadpt->sharedRam[0x11] & MODE1_UARTInterfaceEn)) {
+				setReturnVals(currkbadpt, 0x4B, INTID_Info);
+			} else {
+				// TODO: Implement locator
+				//setReturnVals(currkbadpt, 0x00, INTID_Info);
+				if (currkbadpt->cmdReg & 0x20) {
+					// If bit 5 of the CMD byte is set we do a loopback on the UART
+					circBufPush(&currkbadpt->uartBuf, currkbadpt->PA);
+				} else {
+					currkbadpt->uartCmdIn = currkbadpt->PA;
+				}
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			}
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x05) {
+			// Set UART baud rate
+			logmsgf(LOGKBADPT, "KBADPT: CMD set UART baud rate 0x%02X\n", currkbadpt->PA);
+			currkbadpt->sharedRam[0x1B] = currkbadpt->PA;
+			setReturnVals(currkbadpt, 0x00, INTID_Info);
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x06) {
+			// Init UART framing
+			logmsgf(LOGKBADPT, "KBADPT: CMD init UART framing 0x%02X\n", currkbadpt->PA);
+			if (!(currkbadpt->PA & 0x78) && (currkbadpt->PA & 0x07) > 1 && (currkbadpt->PA & 0x07) < 7) {
+				currkbadpt->sharedRam[0x19] = currkbadpt->PA;
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x4E, INTID_Info);
+			}
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x07) {
+			// Set speaker duration
+			logmsgf(LOGKBADPT, "KBADPT: CMD set speaker duration 0x%02X\n", currkbadpt->PA);
+			if (!(currkbadpt->sharedRam[0x12] & STATUS_SpkQueueFull)) {
+				currkbadpt->sharedRam[0x01] = currkbadpt->PA;
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x4A, INTID_Info);
+			}
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x08) {
+			// Set speaker freq high
+			logmsgf(LOGKBADPT, "KBADPT: CMD set speaker freq high 0x%02X\n", currkbadpt->PA);
+			if (!(currkbadpt->sharedRam[0x12] & STATUS_SpkQueueFull)) {
+				currkbadpt->sharedRam[0x15] = currkbadpt->PA;
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x4A, INTID_Info);
+			}
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x09) {
+			// Set speaker freq low
+			logmsgf(LOGKBADPT, "KBADPT: CMD set speaker freq low 0x%02X\n", currkbadpt->PA);
+			if (!(currkbadpt->sharedRam[0x12] & STATUS_SpkQueueFull)) {
+				currkbadpt->sharedRam[0x16] = currkbadpt->PA;
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x4A, INTID_Info);
+			}
+		} else if ((currkbadpt->cmdReg & 0x1F) == 0x0C) {
+			// Diagnostic write keyboard port pins
+			logmsgf(LOGKBADPT, "KBADPT: CMD diagnostic write keyboard port 0x%02X\n", currkbadpt->PA);
+			if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
+				setReturnVals(currkbadpt, 0x00, INTID_Info);
+			} else {
+				setReturnVals(currkbadpt, 0x51, INTID_Info);
+			}
+		} else if (currkbadpt->cmdReg & 0x10) {
+			// Write shared ram
+			logmsgf(LOGKBADPT, "KBADPT: CMD write shared ram 0x%02X: 0x%02X\n", currkbadpt->cmdReg & 0x0F, currkbadpt->PA);
+			currkbadpt->sharedRam[currkbadpt->cmdReg & 0x0F] = currkbadpt->PA;
+			setReturnVals(currkbadpt, 0x00, INTID_Info);
+		}
 	}
+}
 
+// One pass of the 8051 main loop, sends at most one byte to the host.
+void runkbadpt (struct structkbadpt* currkbadpt) {
 	if (currkbadpt->PC & PC_PAInBufFull) {
 		// Wait for host to process what we have in the PA buff already.
 		return;
@@ -220,12 +469,41 @@ void cyclekbadpt (struct structkbadpt* currkbadpt) {
 		if (ret) {logmsgf(LOGKBADPT, "KBADPT: Error KB Buf full.\n");}
 		currkbadpt->kbCmdIn = 0;
 	}
-	
+
+	if (!(currkbadpt->PC & PC_PAOutBufEmpty)) {
+		// We have a command to process
+		processkbadptCmd(currkbadpt);
+		return;
+	}
+
+	if (currkbadpt->softResetBytes) {
+		// Soft reset pg. 5-107
+		// Requires two additional bytes to be sent, then self-test runs again.
+		setReturnVals(currkbadpt, 0x00, INTID_8051Error);
+		currkbadpt->softResetBytes--;
+		if (!currkbadpt->softResetBytes) {
+			currkbadpt->state = KBSTATE_SELFTEST;
+			scheduleEvent(EVENT_KBADPT, KBADPT_SelfTestTime);
+		}
+		return;
+	}
+
 	// Keyboard buffer not empty send byte
 	if (currkbadpt->kbBuf.head != currkbadpt->kbBuf.tail) {
 		uint8_t byte;
 		circBufPop(&currkbadpt->kbBuf, &byte);
 		setReturnVals(currkbadpt, byte, INTID_KBByteRX);
+		return;
+	}
+
+	if (currkbadpt->sharedRam[0x11] & MODE1_KBInterfaceEn) {
+		// Then anything typed on the host, one byte per PA read
+		uint8_t byte;
+		if (!ringbufRead(&currkbadpt->hostKeys, &byte, 1)) {
+			logmsgf(LOGKBADPT, "KBADPT: Host scan code 0x%02X\n", byte);
+			setReturnVals(currkbadpt, byte, INTID_KBByteRX);
+			return;
+		}
 	}
 
 	// TODO: Process UART (locator) commands in seperate function for readability probably...
@@ -246,13 +524,14 @@ void cyclekbadpt (struct structkbadpt* currkbadpt) {
 
 	// UART buffer not empty
 	if (currkbadpt->sharedRam[0x10] & MODE0_BlockReceivedUARTBytes) {
+		if (!currkbadpt->reportLen && circBufGetLen(&currkbadpt->uartBuf) >= (currkbadpt->sharedRam[0x19] & 0x0F)) {
+			currkbadpt->reportLen = currkbadpt->sharedRam[0x19] & 0x0F;
+		}
 		if (currkbadpt->reportLen) {
 			uint8_t byte;
 			circBufPop(&currkbadpt->uartBuf, &byte);
 			setReturnVals(currkbadpt, byte, INTID_UARTByteRX);
 			currkbadpt->reportLen--;
-		} else if (circBufGetLen(&currkbadpt->uartBuf) >= (currkbadpt->sharedRam[0x19] & 0x0F)) {
-			currkbadpt->reportLen = currkbadpt->sharedRam[0x19] & 0x0F;
 		}
 	} else {
 		if (currkbadpt->uartBuf.head != currkbadpt->uartBuf.tail) {
@@ -263,287 +542,83 @@ void cyclekbadpt (struct structkbadpt* currkbadpt) {
 	}
 
 	// TODO: ramQueue processing
+}
 
-	if (currkbadpt->initReq > RESET_Delay) {
-		// Soft reset pg. 5-107
-		// Requires two additional bytes to be sent...
-		setReturnVals(currkbadpt, 0x00, INTID_8051Error);
-		currkbadpt->initReq--;
+// One UART frame at the baud rate in shared RAM
+uint64_t uartByteTime (struct structkbadpt* currkbadpt) {
+	return ((uint64_t)KBADPT_UARTFrameBits * 1000 * NS_PER_MS * (256 - currkbadpt->sharedRam[0x1B])) / KBADPT_UARTBaudClock;
+}
+
+// Work out when the 8051 next has something to do and schedule it.
+void schedulekbadpt (struct structkbadpt* currkbadpt) {
+	if (currkbadpt->state != KBSTATE_RUN) {return;}
+
+	if (currkbadpt->PC & PC_PAInBufFull) {
+		// Nothing until the host reads PA, readkbadpt() reschedules us.
+		cancelEvent(EVENT_KBADPT);
+		return;
 	}
 
-	if (!(currkbadpt->PC & PC_PAOutBufEmpty)) {
-		// We have a command to process
-		currkbadpt->PC |= PC_PAOutBufEmpty;
-		currkbadpt->PC &= ~PC_IntReq;
+	uint8_t uartReady;
+	if (currkbadpt->sharedRam[0x10] & MODE0_BlockReceivedUARTBytes) {
+		uartReady = currkbadpt->reportLen || (circBufGetLen(&currkbadpt->uartBuf) >= (currkbadpt->sharedRam[0x19] & 0x0F));
+	} else {
+		uartReady = circBufGetLen(&currkbadpt->uartBuf) != 0;
+	}
+
+	if (!(currkbadpt->PC & PC_PAOutBufEmpty) || currkbadpt->softResetBytes) {
+		scheduleEventBefore(EVENT_KBADPT, KBADPT_CmdTime);
+	} else if (currkbadpt->kbCmdIn == 0xFF || circBufGetLen(&currkbadpt->kbBuf)) {
+		scheduleEventBefore(EVENT_KBADPT, KBADPT_KBByteTime);
+	} else if (currkbadpt->reportLen) {
+		// Rest of a UART block report
+		scheduleEventBefore(EVENT_KBADPT, KBADPT_CmdTime);
+	} else if (uartReady) {
+		scheduleEventBefore(EVENT_KBADPT, uartByteTime(currkbadpt));
+	} else if ((currkbadpt->sharedRam[0x11] & MODE1_KBInterfaceEn) && ringbufLen(&currkbadpt->hostKeys)) {
+		scheduleEventBefore(EVENT_KBADPT, KBADPT_KBByteTime);
+	}
+}
+
+// Emulation thread side of kbadptHostKey(), once told new keys are queued.
+void kbadptHostKeysPending (struct structkbadpt* currkbadpt) {
+	schedulekbadpt(currkbadpt);
+}
+
+// Reset line from CRRB, only called when it is written.
+void setkbadptReset (struct structkbadpt* currkbadpt, uint8_t reset) {
+	if (reset == currkbadpt->reset) {return;}
+	currkbadpt->reset = reset;
+	if (!reset) {
+		logmsgf(LOGKBADPT, "KBADPT: Held in reset\n");
+		currkbadpt->irqEn = 0;
 		currkbadpt->intReq = 0;
-		if (currkbadpt->cmdReg & 0xE0) {logmsgf(LOGKBADPT, "KBADPT: Diag CMD bits not zero CMD:0x%02X PA:0x%02X\n", currkbadpt->cmdReg, currkbadpt->PA);}
-		if (currkbadpt->cmdReg == 0) {
-			// Extended commands pg. 5-99
-			if (currkbadpt->PA >= 0x00 && currkbadpt->PA <= 0x1F) {
-				// Read shared ram
-				uint8_t offset = currkbadpt->PA;
-				setReturnVals(currkbadpt, currkbadpt->sharedRam[offset], INTID_RetReqByte);
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD read ram 0x%02X: 0x%02X\n", offset, currkbadpt->PA);
-			} else if (currkbadpt->PA >= 0x20 && currkbadpt->PA <= 0x2F) {
-				// Reset mode bit
-				if (!(currkbadpt->PA & 0x08)) {
-					logmsgf(LOGKBADPT, "KBADPT: ExtCMD reset mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x10]);
-					currkbadpt->sharedRam[0x10] &= ~(0x01 << (currkbadpt->PA & 0x07));
-					logmsgf(LOGKBADPT, "KBADPT:                          0x%02X\n", currkbadpt->sharedRam[0x10]);
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					if (currkbadpt->PA == 11) {
-						if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
-							logmsgf(LOGKBADPT, "KBADPT: ExtCMD reset mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x11]);
-							currkbadpt->sharedRam[0x11] &= ~(0x01 << (currkbadpt->PA & 0x07));
-							logmsgf(LOGKBADPT, "KBADPT:                          0x%02X\n", currkbadpt->sharedRam[0x11]);
-							setReturnVals(currkbadpt, 0x00, INTID_Info);
-						} else {
-							logmsgf(LOGKBADPT, "KBADPT: Error can't disable keyboard when not in Diag mode\n");
-							setReturnVals(currkbadpt, 0x51, INTID_Info);
-						}
-					} else {
-						currkbadpt->sharedRam[0x11] &= ~(0x01 << (currkbadpt->PA & 0x07));
-						setReturnVals(currkbadpt, 0x00, INTID_Info);
-					}
-				}
-			} else if (currkbadpt->PA >= 0x30 && currkbadpt->PA <= 0x3F) {
-				// Set mode bit
-				if (!(currkbadpt->PA & 0x08)) {
-					logmsgf(LOGKBADPT, "KBADPT: ExtCMD set mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x10]);
-					currkbadpt->sharedRam[0x10] |= 0x01 << (currkbadpt->PA & 0x07);
-					logmsgf(LOGKBADPT, "KBADPT:                        0x%02X\n", currkbadpt->sharedRam[0x10]);
-				} else {
-					logmsgf(LOGKBADPT, "KBADPT: ExtCMD set mode bit %d 0x%02X\n", currkbadpt->PA & 0x0F, currkbadpt->sharedRam[0x11]);
-					currkbadpt->sharedRam[0x11] |= 0x01 << (currkbadpt->PA & 0x07);
-					logmsgf(LOGKBADPT, "KBADPT:                        0x%02X\n", currkbadpt->sharedRam[0x11]);
-				}
-				setReturnVals(currkbadpt, 0x00, INTID_Info);
-			} else if (currkbadpt->PA >= 0x40 && currkbadpt->PA <= 0x43) {
-				currkbadpt->sharedRam[0x11] = (currkbadpt->sharedRam[0x11] & ~MODE1_SpkVol) | currkbadpt->PA & MODE1_SpkVol;
-				setReturnVals(currkbadpt, 0x00, INTID_Info);
-			} else if (currkbadpt->PA == 0x44) {
-				// Terminate speaker and reset duration
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD terminate speaker\n");
-				if (currkbadpt->sharedRam[0x12] & (STATUS_SpkTimerBusy | STATUS_TimeoutTimerBsy)) {
-					currkbadpt->sharedRam[0x12] &= ~(STATUS_SpkQueueFull | STATUS_SpkTimerBusy | STATUS_TimeoutTimerBsy);
-					currkbadpt->sharedRam[0x13] = 0x00;
-					currkbadpt->sharedRam[0x14] = 0x00;
-					setReturnVals(currkbadpt, 0x03, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x02, INTID_Info);
-				}
-			} else if (currkbadpt->PA >= 0x50 && currkbadpt->PA <= 0x5F) {
-				// Set scan count for sys attn keystroke sequence
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD set scan count %d\n", currkbadpt->PA & 0x0F);
-				if (currkbadpt->PA >= 0x51 && currkbadpt->PA <= 0x53) {
-					currkbadpt->sharedRam[0x17] = currkbadpt->PA & 0x0F;
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x50, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x60) {
-				// Execute 8051 soft reset
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD 8051 soft reset\n");
-				if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
-					currkbadpt->initReq = SOFTRESET_Delay;
-					setReturnVals(currkbadpt, 0xA0, INTID_8051Error);
-				} else {
-					setReturnVals(currkbadpt, 0x51, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x61) {
-				// Force system reset
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD force system reset\n");
-				if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
-					// TODO: Reset system...
-				} else {
-					setReturnVals(currkbadpt, 0x51, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x62) {
-				// Force system attn interrupt
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD force system attention interrupt\n");
-				if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
-					// TODO: System atten interrupt
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x51, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x62) {
-				// Diagnostic sense keyboard/UART port pins
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD diagnostic sense keyboard/UART\n");
-				if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
-					// Probably don't have to return anything sensible here.
-					setReturnVals(currkbadpt, 0x00, 0x3);
-				} else {
-					setReturnVals(currkbadpt, 0x51, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x80) {
-				// Dump adapter shared 0x00-0x0F
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump adapter shared 0x00-0x0F\n");
-				if (!currkbadpt->ramQueue) {
-					currkbadpt->ramOffset = 0x00;
-					currkbadpt->ramQueue = 0x0F;
-					currkbadpt->ramClear = 0;
-					//setReturnVals(currkbadpt, 0x00, INTID_Info);
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x81) {
-				// Dump adapter shared 0x10-0x1F
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump adapter shared 0x10-0x1F\n");
-				if (!currkbadpt->ramQueue) {
-					currkbadpt->ramOffset = 0x10;
-					currkbadpt->ramQueue = 0x0F;
-					currkbadpt->ramClear = 0;
-					//setReturnVals(currkbadpt, 0x00, INTID_Info);
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x82) {
-				// Dump RAS logs 0x20-0x2B
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump RAS logs 0x20-0x2B\n");
-				if (!currkbadpt->ramQueue) {
-					currkbadpt->ramOffset = 0x20;
-					currkbadpt->ramQueue = 0x0B;
-					currkbadpt->ramClear = 0;
-					//setReturnVals(currkbadpt, 0x00, INTID_Info);
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x83) {
-				// Dump RAS logs 0x20-0x2B with clear
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD dump RAS logs with clear 0x20-0x2B\n");
-				if (!currkbadpt->ramQueue) {
-					currkbadpt->ramOffset = 0x20;
-					currkbadpt->ramQueue = 0x0B;
-					currkbadpt->ramClear = 1;
-					//setReturnVals(currkbadpt, 0x00, INTID_Info);
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x60, INTID_Info);
-				}
-			} else if (currkbadpt->PA == 0x83) {
-				// Restore initial conditions
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD restore initial conditions\n");
-				initSharedRam(currkbadpt); // Really should only init to 0x1B, but this should be OK
-				setReturnVals(currkbadpt, 0x00, INTID_Info);
-			} else if (currkbadpt->PA >= 0xE0 && currkbadpt->PA <= 0xEF) {
-				// Read 8051 release marker
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD read 8051 release marker\n");
-				setReturnVals(currkbadpt, 0x00, 0x3); // Should return valid data?
-			} else if (currkbadpt->PA >= 0xF0 && currkbadpt->PA <= 0xFF) {
-				// NOP
-				logmsgf(LOGKBADPT, "KBADPT: ExtCMD NOP\n");
-				setReturnVals(currkbadpt, 0x00, INTID_Info);
-			}
-		} else {
-			// Non-extended Commands pg. 5-102
-			if ((currkbadpt->cmdReg & 0x1F) == 0x01) {
-				// Write to keyboard
-				logmsgf(LOGKBADPT, "KBADPT: CMD write to keyboard 0x%02X\n", currkbadpt->PA);
-				if (currkbadpt->keylock && (currkbadpt->sharedRam[0x11] & MODE1_HonorKeylock)) {
-					setReturnVals(currkbadpt, 0x42, INTID_Info);
-				} else if (!(currkbadpt->sharedRam[0x11] & MODE1_KBInterfaceEn)) {
-					setReturnVals(currkbadpt, 0x43, INTID_Info);
-				} else if (currkbadpt->PA == currkbadpt->sharedRam[0x03]) {
-					setReturnVals(currkbadpt, 0x44, INTID_Info);
-				} else {
-					// TODO
-					currkbadpt->kbCmdIn = currkbadpt->PA;
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				}
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x02) {
-				// Write to speaker
-				logmsgf(LOGKBADPT, "KBADPT: CMD write to speaker 0x%02X\n", currkbadpt->PA);
-				// TODO
-				setReturnVals(currkbadpt, 0x01, INTID_Info);
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x03) {
-				// Write to UART - control
-				logmsgf(LOGKBADPT, "KBADPT: CMD write to UART control 0x%02X\n", currkbadpt->PA);
-				if (currkbadpt->keylock && (currkbadpt->sharedRam[0x11] & MODE1_HonorKeylock)) {
-					setReturnVals(currkbadpt, 0x42, INTID_Info);
-				} else if (!(currkbadpt->sharedRam[0x11] & MODE1_UARTInterfaceEn)) {
-					setReturnVals(currkbadpt, 0x4B, INTID_Info);
-				} else {
-					currkbadpt->uartCmdIn = currkbadpt->PA;
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				}
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x04) {
-				// Write to UART - query
-				logmsgf(LOGKBADPT, "KBADPT: CMD write to UART query 0x%02X\n", currkbadpt->PA);
-				if (currkbadpt->keylock && (currkbadpt->sharedRam[0x11] & MODE1_HonorKeylock)) {
-					setReturnVals(currkbadpt, 0x42, INTID_Info);
-				} else if (!(currkbadpt->sharedRam[0x11] & MODE1_UARTInterfaceEn)) {
-					setReturnVals(currkbadpt, 0x4B, INTID_Info);
-				} else {
-					// TODO: Implement locator
-					//setReturnVals(currkbadpt, 0x00, INTID_Info);
-					if (currkbadpt->cmdReg & 0x20) {
-						// If bit 5 of the CMD byte is set we do a loopback on the UART
-						circBufPush(&currkbadpt->uartBuf, currkbadpt->PA);
-					} else {
-						currkbadpt->uartCmdIn = currkbadpt->PA;
-					}
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				}
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x05) {
-				// Set UART baud rate
-				logmsgf(LOGKBADPT, "KBADPT: CMD set UART baud rate 0x%02X\n", currkbadpt->PA);
-				currkbadpt->sharedRam[0x1B] = currkbadpt->PA;
-				setReturnVals(currkbadpt, 0x00, INTID_Info);
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x06) {
-				// Init UART framing
-				logmsgf(LOGKBADPT, "KBADPT: CMD init UART framing 0x%02X\n", currkbadpt->PA);
-				if (!(currkbadpt->PA & 0x78) && (currkbadpt->PA & 0x07) > 1 && (currkbadpt->PA & 0x07) < 7) {
-					currkbadpt->sharedRam[0x19] = currkbadpt->PA;
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x4E, INTID_Info);
-				}
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x07) {
-				// Set speaker duration
-				logmsgf(LOGKBADPT, "KBADPT: CMD set speaker duration 0x%02X\n", currkbadpt->PA);
-				if (!(currkbadpt->sharedRam[0x12] & STATUS_SpkQueueFull)) {
-					currkbadpt->sharedRam[0x01] = currkbadpt->PA;
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x4A, INTID_Info);
-				}
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x08) {
-				// Set speaker freq high
-				logmsgf(LOGKBADPT, "KBADPT: CMD set speaker freq high 0x%02X\n", currkbadpt->PA);
-				if (!(currkbadpt->sharedRam[0x12] & STATUS_SpkQueueFull)) {
-					currkbadpt->sharedRam[0x15] = currkbadpt->PA;
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x4A, INTID_Info);
-				}
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x09) {
-				// Set speaker freq low
-				logmsgf(LOGKBADPT, "KBADPT: CMD set speaker freq low 0x%02X\n", currkbadpt->PA);
-				if (!(currkbadpt->sharedRam[0x12] & STATUS_SpkQueueFull)) {
-					currkbadpt->sharedRam[0x16] = currkbadpt->PA;
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x4A, INTID_Info);
-				}
-			} else if ((currkbadpt->cmdReg & 0x1F) == 0x0C) {
-				// Diagnostic write keyboard port pins
-				logmsgf(LOGKBADPT, "KBADPT: CMD diagnostic write keyboard port 0x%02X\n", currkbadpt->PA);
-				if (currkbadpt->sharedRam[0x11] & MODE1_DiagMode) {
-					setReturnVals(currkbadpt, 0x00, INTID_Info);
-				} else {
-					setReturnVals(currkbadpt, 0x51, INTID_Info);
-				}
-			} else if (currkbadpt->cmdReg & 0x10) {
-				// Write shared ram
-				logmsgf(LOGKBADPT, "KBADPT: CMD write shared ram 0x%02X: 0x%02X\n", currkbadpt->cmdReg & 0x0F, currkbadpt->PA);
-				currkbadpt->sharedRam[currkbadpt->cmdReg & 0x0F] = currkbadpt->PA;
-				setReturnVals(currkbadpt, 0x00, INTID_Info);
-			}
-		}
+		currkbadpt->softResetBytes = 0;
+		currkbadpt->state = KBSTATE_RESET;
+		cancelEvent(EVENT_KBADPT);
+	} else {
+		// Simulate 8051 initializing
+		currkbadpt->state = KBSTATE_SELFTEST;
+		scheduleEvent(EVENT_KBADPT, KBADPT_SelfTestTime);
+	}
+}
+
+void eventkbadpt (struct structkbadpt* currkbadpt) {
+	// This event acts like the 8051 running.
+	switch (currkbadpt->state) {
+		case KBSTATE_RESET:
+			return;
+		case KBSTATE_SELFTEST:
+			logmsgf(LOGKBADPT, "KBADPT: Initialized after reset released\n");
+			initSharedRam(currkbadpt);
+			setReturnVals(currkbadpt, 0xAE, INTID_8051SelfTest);
+			currkbadpt->state = KBSTATE_RUN;
+			break;
+		case KBSTATE_RUN:
+			runkbadpt(currkbadpt);
+			break;
 	}
-}
\ No newline at end of file
+
+	currkbadpt->intReq = (currkbadpt->PC & PC_IntReq) ? 1 : 0;
+	schedulekbadpt(currkbadpt);
+}
@@ -3,12 +3,27 @@
 #define _KB_ADAPTER
 #include <stdint.h>
 #include "iocc.h"
+#include "ringbuf.h"
+#include "events.h"
 
-#define RESET_Delay 8192
-#define SOFTRESET_Delay RESET_Delay+2
+// 8051 latencies in emulated time
+#define KBADPT_SelfTestTime	(4 * NS_PER_MS)		// Reset released to self-test complete
+#define KBADPT_CmdTime			(20 * NS_PER_US)	// Command received to response
+#define KBADPT_KBByteTime		(1 * NS_PER_MS)		// One byte over the keyboard serial link
+// UART rate is set by the 8051 timer 1 reload in shared RAM 0x1B. Taking an
+// 18.432 MHz 8051 with SMOD clear that's 48000 / (256 - reload) baud, which
+// makes the default 0xFB 9600.
+#define KBADPT_UARTBaudClock	48000
+#define KBADPT_UARTFrameBits	11		// Start, 8 data, parity, stop
 
-#define BUFMAX 16
+#define KBSTATE_RESET			0
+#define KBSTATE_SELFTEST	1
+#define KBSTATE_RUN				2
 
+#define BUFMAX 16		// Must be a power of two
+#define HOSTKEYMAX 64	// Must be a power of two
+
+// head and tail free-run, length is head - tail
 struct circ_buf {
     uint8_t buffer[BUFMAX];
     uint8_t head;
@@ -19,7 +34,8 @@ struct structkbadpt {
 	uint32_t ioAddress;
 	uint32_t ioAddressMask;
 	uint8_t reset;
-	uint32_t initReq;
+	uint8_t state;
+	uint8_t softResetBytes;
 	uint8_t cmdReg;
 	uint8_t PA;
 	uint8_t PB;
@@ -36,6 +52,8 @@ struct structkbadpt {
 	uint8_t uartCmdIn;
 	uint8_t reportLen;
 	struct circ_buf uartBuf;
+	struct ringbuf hostKeys;	// Scan codes from the host keyboard (GUI thread produces)
+	uint8_t hostKeyBuf[HOSTKEYMAX];
 };
 
 #define PC_PAOutBufEmpty	0x80
@@ -79,6 +97,9 @@ struct structkbadpt {
 
 void initkbadpt (struct structkbadpt* currkbadpt, struct ioBusStruct* ioBusPointer, uint32_t ioaddr, uint32_t ioaddrMask);
 void accesskbadpt (struct structkbadpt* currkbadpt);
-void cyclekbadpt (struct structkbadpt* currkbadpt);
+void setkbadptReset (struct structkbadpt* currkbadpt, uint8_t reset);
+void eventkbadpt (struct structkbadpt* currkbadpt);
+int kbadptHostKey (struct structkbadpt* currkbadpt, uint8_t scancode, uint8_t make);
+void kbadptHostKeysPending (struct structkbadpt* currkbadpt);
 
 #endif
\ No newline at end of file
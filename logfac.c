@@ -4,22 +4,209 @@
 #include <stdint.h>
 #include <stdarg.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 #include "logfac.h"
+#include "ringbuf.h"
 
-FILE *logfile = NULL;
+// Messages are formatted into the ring by the emulation thread (the only
+// producer) and written out in large chunks by the writer thread.
+int logfd = -1;
 unsigned int logtype = 0;
+int logFullPolicy = LOGFULL_BLOCK;
+struct ringbuf logRing;
+uint8_t logRingBuf[LOGRINGSIZE];
+atomic_uint_fast64_t logDropped;
+uint64_t logDroppedReported = 0;
+
+// Instruction count index, marks are queued by the emulation thread with the
+// stream offset of the message that follows and written out by the writer
+// thread once it knows which file that offset landed in.
+struct logIndexMark {
+	uint64_t count;
+	uint64_t offset;
+};
+
+char logName[256];
+int logIndexfd = -1;
+uint64_t (*logCounter)(void) = NULL;
+uint64_t logIndexNext = 0;
+uint64_t logQueued = 0;		// Stream bytes queued, emulation thread only
+struct ringbuf logIndexRing;
+uint8_t logIndexRingBuf[LOGINDEXRING];
+// Writer thread only
+_Atomic uint64_t logRotateSize = LOGROTATESIZE;
+uint64_t logWritten = 0;	// Stream bytes written, all segments
+uint64_t logSegWritten = 0;
+uint32_t logSegment = 0;
+
+// Who may consume the rings. The writer thread normally, a fatal signal takes
+// them over only while the writer isn't in logDrain(), so there's only ever
+// one consumer, and the writer stops once they're taken.
+#define LOGOWNER_IDLE		0	// Writer's, not draining
+#define LOGOWNER_WRITER	1	// Writer is draining
+#define LOGOWNER_SIGNAL	2	// Handed to a fatal signal handler
+#define LOGSIGNALWAITMS	100	// How long a handler waits for the writer to finish
+
+atomic_int logOwner;
+
+pthread_t logThread;
+pthread_mutex_t logLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t logCond = PTHREAD_COND_INITIALIZER;
+atomic_int logQuit;
+
+// Index marks for messages that are now in the current file
+void logIndexWrite (int all) {
+	struct logIndexMark mark;
+	uint8_t *data;
+	while (ringbufPeek(&logIndexRing, &data) >= sizeof(mark)) {
+		memcpy(&mark, data, sizeof(mark));
+		if (mark.offset > logWritten || (mark.offset == logWritten && !all)) {return;}
+		char line[64];
+		int len = snprintf(line, sizeof(line), "%llu %u %llu\n", (unsigned long long)mark.count, logSegment,
+			(unsigned long long)(mark.offset - (logWritten - logSegWritten)));
+		if (write(logIndexfd, line, len) != len) {return;}
+		ringbufConsume(&logIndexRing, sizeof(mark));
+	}
+}
+
+void logRotate (void) {
+	char name[sizeof(logName) + 16];
+	snprintf(name, sizeof(name), "%s.%u", logName, logSegment + 1);
+	int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {return;}	// Carry on in the old one
+	close(logfd);
+	logfd = fd;
+	logSegment++;
+	logSegWritten = 0;
+}
+
+int logClaim (int owner) {
+	int idle = LOGOWNER_IDLE;
+	return atomic_compare_exchange_strong(&logOwner, &idle, owner);
+}
+
+// Write whatever is queued, only whoever holds logOwner calls this
+void logDrain (void) {
+	uint8_t *data;
+	uint32_t len;
+	while ((len = ringbufPeek(&logRing, &data))) {
+		// Past the rotation size, finish the line and start the next file
+		uint64_t rotateSize = atomic_load_explicit(&logRotateSize, memory_order_relaxed);
+		int rotate = 0;
+		if (rotateSize && logSegWritten + len > rotateSize) {
+			uint32_t from = (logSegWritten < rotateSize) ? rotateSize - logSegWritten : 0;
+			uint8_t *end = memchr(data + from, '\n', len - from);
+			if (end) {
+				len = end - data + 1;
+				rotate = 1;
+			}
+		}
+		ssize_t written = write(logfd, data, len);
+		if (written <= 0) {return;}
+		ringbufConsume(&logRing, written);
+		logWritten += written;
+		logSegWritten += written;
+		if (logIndexfd >= 0) {logIndexWrite(0);}
+		if (rotate && written == len) {logRotate();}
+	}
+}
+
+void* logThreadMain (void* arg) {
+	(void)arg;
+	while (!atomic_load(&logQuit)) {
+		pthread_mutex_lock(&logLock);
+		if (ringbufLen(&logRing) < LOGWAKELEN && !atomic_load(&logQuit)) {
+			struct timespec deadline;
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_nsec += LOGFLUSHMS * 1000000;
+			if (deadline.tv_nsec >= 1000000000) {
+				deadline.tv_sec++;
+				deadline.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&logCond, &logLock, &deadline);
+		}
+		pthread_mutex_unlock(&logLock);
+		if (!logClaim(LOGOWNER_WRITER)) {return NULL;}
+		logDrain();
+		atomic_store(&logOwner, LOGOWNER_IDLE);
+	}
+	if (logClaim(LOGOWNER_WRITER)) {
+		logDrain();
+		if (logIndexfd >= 0) {logIndexWrite(1);}
+		atomic_store(&logOwner, LOGOWNER_IDLE);
+	}
+	return NULL;
+}
+
+// Last chance to get the log out if we crash. If the writer thread is what
+// crashed mid drain it never lets go, and what's queued is lost.
+void logSignal (int sig) {
+	for (int waited=0; logfd >= 0 && waited < LOGSIGNALWAITMS; waited++) {
+		if (logClaim(LOGOWNER_SIGNAL)) {
+			logDrain();
+			if (logIndexfd >= 0) {logIndexWrite(1);}
+			break;
+		}
+		struct timespec idle = {0, 1000000};
+		nanosleep(&idle, NULL);
+	}
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
 
 void loginit (const char *file) {
-	logfile = fopen(file, "w");
-	if (!logfile) {
-		logfile = NULL;
+	logfd = open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (logfd < 0) {return;}
+	snprintf(logName, sizeof(logName), "%s", file);
+	char name[sizeof(logName) + 8];
+	snprintf(name, sizeof(name), "%s%s", file, LOGINDEXSUFFIX);
+	logIndexfd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (logIndexfd >= 0) {
+		const char *header = "# instruction count, segment (0 is the log itself, n is .n), offset\n";
+		if (write(logIndexfd, header, strlen(header)) < 0) {
+			close(logIndexfd);
+			logIndexfd = -1;
+		}
 	}
+	ringbufInit(&logIndexRing, logIndexRingBuf, sizeof(logIndexRingBuf));
+	ringbufInit(&logRing, logRingBuf, sizeof(logRingBuf));
+	atomic_store(&logDropped, 0);
+	atomic_store(&logQuit, 0);
+	atomic_store(&logOwner, LOGOWNER_IDLE);
+	if (pthread_create(&logThread, NULL, logThreadMain, NULL)) {
+		printf("Error creating log writer thread\n");
+		close(logfd);
+		logfd = -1;
+		return;
+	}
+	signal(SIGSEGV, logSignal);
+	signal(SIGBUS, logSignal);
+	signal(SIGFPE, logSignal);
+	signal(SIGILL, logSignal);
+	signal(SIGABRT, logSignal);
 }
 
 void logend (void) {
-	if (logfile != NULL) {
-		fclose(logfile);
+	if (logfd < 0) {return;}
+	pthread_mutex_lock(&logLock);
+	atomic_store(&logQuit, 1);
+	pthread_cond_signal(&logCond);
+	pthread_mutex_unlock(&logLock);
+	pthread_join(logThread, NULL);
+	if (atomic_load(&logDropped)) {
+		printf("Log ring full, dropped %llu messages\n", (unsigned long long)atomic_load(&logDropped));
+	}
+	close(logfd);
+	logfd = -1;
+	if (logIndexfd >= 0) {
+		close(logIndexfd);
+		logIndexfd = -1;
 	}
 }
 
@@ -27,14 +214,83 @@ void enlogtypes (unsigned int type) {
 	logtype = type;
 }
 
+unsigned int getlogtypes (void) {
+	return logtype;
+}
+
+void logsetfullpolicy (int policy) {
+	logFullPolicy = policy;
+}
+
+void logsetrotate (uint64_t bytes) {
+	atomic_store(&logRotateSize, bytes);
+}
+
+// Where index marks get their instruction count, nothing is indexed without one
+void logsetcounter (uint64_t (*counter)(void)) {
+	logCounter = counter;
+}
+
+uint64_t getLogDropped (void) {
+	return atomic_load(&logDropped);
+}
+
+// For skipping work that only feeds a log message
+int logEnabled (unsigned int type) {
+	return logfd >= 0 && (logtype & type);
+}
+
+void logWake (void) {
+	pthread_mutex_lock(&logLock);
+	pthread_cond_signal(&logCond);
+	pthread_mutex_unlock(&logLock);
+}
+
+void logIndexMark (uint64_t count) {
+	struct logIndexMark mark = {count, logQueued};
+	// A full ring just makes the index sparser
+	ringbufWrite(&logIndexRing, &mark, sizeof(mark));
+	logIndexNext = count - (count % LOGINDEXINSTS) + LOGINDEXINSTS;
+}
+
+void logQueue (const char* msg, uint32_t len) {
+	if (ringbufLen(&logRing) < LOGWAKELEN && (ringbufLen(&logRing) + len) >= LOGWAKELEN) {
+		logWake();
+	}
+	while (ringbufWrite(&logRing, msg, len)) {
+		if (logFullPolicy == LOGFULL_DROP) {
+			atomic_fetch_add(&logDropped, 1);
+			return;
+		}
+		// LOGFULL_BLOCK, wait for the writer to make room
+		logWake();
+		struct timespec idle = {0, 100000};
+		nanosleep(&idle, NULL);
+	}
+	logQueued += len;
+}
+
 int logmsgf (unsigned int type, const char *format, ...) {
 	va_list args;
-	int ret;
-	if (logfile != NULL && logtype & type) {
+	char msg[LOGMSGMAX];
+	int ret = 0;
+	if (logfd >= 0 && logtype & type) {
+		if (logCounter && logIndexfd >= 0) {
+			uint64_t count = logCounter();
+			if (count >= logIndexNext) {logIndexMark(count);}
+		}
+		// Note any drops in the log itself once there is room again
+		uint64_t dropped = atomic_load_explicit(&logDropped, memory_order_relaxed);
+		if (dropped != logDroppedReported && ringbufFree(&logRing) > (LOGRINGSIZE / 2)) {
+			int len = snprintf(msg, sizeof(msg), "LOG: Ring full, dropped %llu messages\n", (unsigned long long)(dropped - logDroppedReported));
+			logDroppedReported = dropped;
+			logQueue(msg, len);
+		}
 		va_start(args, format);
-		ret = vfprintf(logfile, format, args);
-		fflush(logfile);
+		ret = vsnprintf(msg, sizeof(msg), format, args);
 		va_end(args);
+		if (ret < 0) {return ret;}
+		logQueue(msg, (ret < LOGMSGMAX) ? ret : (LOGMSGMAX - 1));
 	}
 	return ret;
 }
@@ -45,63 +301,3 @@ void dumpMemory(uint8_t* memory) {
 	fwrite(memory, sizeof(uint8_t), 8388608, fptr);
 	fclose(fptr);
 }
-
-const char* getCSname (unsigned int CSnum) {
-	switch (CSnum) {
-		case 0x8:
-			return "0";
-		case 0x9:
-			return "LT";
-		case 0xA:
-			return "EQ";
-		case 0xB:
-			return "GT";
-		case 0xC:
-			return "C0";
-		case 0xE:
-			return "OV";
-		case 0xF:
-			return "TB";
-		default:
-			return "RESV";
-	}
-}
-
-const char* gpr_or_0 (unsigned int r3) {
-	switch (r3) {
-		case 0x0:
-			return "0";
-		case 0x1:
-			return "GPR1";
-		case 0x2:
-			return "GPR2";
-		case 0x3:
-			return "GPR3";
-		case 0x4:
-			return "GPR4";
-		case 0x5:
-			return "GPR5";
-		case 0x6:
-			return "GPR6";
-		case 0x7:
-			return "GPR7";
-		case 0x8:
-			return "GPR8";
-		case 0x9:
-			return "GPR9";
-		case 0xA:
-			return "GPR10";
-		case 0xB:
-			return "GPR11";
-		case 0xC:
-			return "GPR12";
-		case 0xD:
-			return "GPR13";
-		case 0xE:
-			return "GPR14";
-		case 0xF:
-			return "GPR15";
-		default:
-			return "ERR";
-	}
-}
\ No newline at end of file
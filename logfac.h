@@ -1,6 +1,7 @@
 // Logging Facility
 #ifndef _LOGFAC
 #define _LOGFAC
+#include <stdint.h>
 // Logging types
 #define LOGALL 		0xFFFFFFFF
 #define LOGINSTR	0x00000001
@@ -14,14 +15,35 @@
 #define LOGKBADPT	0x00000100
 #define LOGRTC		0x00000200
 
+// What logmsgf() does when the writer thread can't keep up
+#define LOGFULL_BLOCK	0	// Wait for room, nothing is lost
+#define LOGFULL_DROP	1	// Count it and carry on, the count is logged later
+
+#define LOGRINGSIZE	(4*1024*1024)	// Must be a power of two
+#define LOGWAKELEN	(LOGRINGSIZE / 4)	// Wake the writer early past this much
+#define LOGFLUSHMS	20	// Otherwise it writes out this often
+#define LOGMSGMAX		1024	// Longer messages are truncated
+
+// Long logs are split into log.txt, log.txt.1, log.txt.2... at the first line
+// end past the rotation size. log.txt.idx indexes them by instruction count,
+// a line of "count segment offset" for the first message logged at or after
+// every LOGINDEXINSTS instructions (tools/logseek reads it). Binary traces
+// use the same index format, see trace.h.
+#define LOGROTATESIZE		(1024ULL*1024*1024)	// Default, 0 never rotates
+#define LOGINDEXINSTS		100000
+#define LOGINDEXSUFFIX	".idx"
+#define LOGINDEXRING		65536	// Marks waiting for the writer, must be a power of two
+
 void loginit (const char *file);
 void logend (void);
 void enlogtypes (unsigned int type);
+unsigned int getlogtypes (void);
+void logsetfullpolicy (int policy);
+void logsetrotate (uint64_t bytes);
+void logsetcounter (uint64_t (*counter)(void));
+uint64_t getLogDropped (void);
+int logEnabled (unsigned int type);
 int logmsgf (unsigned int type, const char *format, ...);
 void dumpMemory(uint8_t* memory);
 
-// Helper functions for logging to get human readable text.
-
-const char* getCSname (unsigned int CSnum);
-const char* gpr_or_0 (unsigned int r3);
 #endif
\ No newline at end of file
@@ -1,8 +1,11 @@
 // IBM PC RT Emulator
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <unistd.h>
+#include <signal.h>
 
 #include "defs.h"
 #include "logfac.h"
@@ -10,7 +13,24 @@
 #include "mmu.h"
 #include "iocc.h"
 #include "memory.h"
+#include "emu.h"
+#include "perf.h"
+#include "screenrec.h"
+#include "shmexport.h"
+#include "trace.h"
+#include "triggers.h"
+#include "profile.h"
+#include "coverage.h"
+#include "timeline.h"
+#include "symbols.h"
+#include "hostprof.h"
+#include "events.h"
+#include "options.h"
+#ifdef HEADLESS
+#include "headless.h"
+#else
 #include "gui.h"
+#endif
 
 uint8_t *memptr;
 uint32_t *GPRptr;
@@ -21,66 +41,67 @@ uint8_t *displayCode;
 // A pointer to this is handed to each unit who needs it (romp.c, mmu.c, iocc.c)
 struct procBusStruct procBus;
 
-uint64_t ticks = 0;
-int prevSS = 0;
-int prevCont = 0;
-int halt = 0;
-
-int main (void) {
-	gui_init();
+int main (int argc, char *argv[]) {
 	loginit("log.txt");
+	logsetcounter(getInstCount);
+	// Stop and shut down normally so everything gets written out
+	signal(SIGINT, emuQuitHandler);
+	signal(SIGTERM, emuQuitHandler);
 	//enlogtypes(LOGALL);
+	triggerinit();
 	memptr = meminit();
 	rominit("bins/79X34xx.BIN");
 	ioinit(&procBus);
 	SCRptr = getSCRptr();
 	displayCode = mmuinit(memptr, &procBus);
 	GPRptr = procinit(&procBus);
+	emuinit(memptr, GPRptr, SCRptr, getMDAPtr(), displayCode);
 
-	romp_pointers(GPRptr, SCRptr, memptr, getMDAPtr(), displayCode);
-	int close = 0;
+#ifdef HEADLESS
+	// No window, the emulation runs on this thread
+	int ret = headlessMain(argc, argv, getMDAPtr(), displayCode);
+	logend();
+	return ret;
+#else
+	int opt;
+	while ((opt = getopt(argc, argv, COMMONOPTS)) != -1) {
+		int ret = parseCommonOpt(opt, optarg, getMDAPtr(), displayCode);
+		if (ret < 0) {optionsUsage(argv[0], NULL);}
+		if (ret) {return 1;}
+	}
 
-	while(!close) {
-		// Enable logging after certain address to save log file size... 0x008021B2: Before SysBoard IO regs tests 0x00806724: Before KBADPT init.
-		if (SCRptr->IAR == 0x008021B2) {
-			enlogtypes(LOGALL);
-		}
-		if ((SDL_GetTicks64() - ticks) >= 16) {
-			ticks = SDL_GetTicks64();
-			close = gui_update();
-		}
-		if (prevSS != getSingleStep()) {
-			prevSS = getSingleStep();
-			fetch();
-			iocycle();
-		}
-		if (prevCont != getContinueBtn()) {
-			prevCont = getContinueBtn();
-			if (halt) {
-				halt = 0;
-				if (SCRptr->IAR == getBreakPoint()) {
-					fetch();
-					iocycle();
-				}
-			} else {
-				halt = 1;
-				printInstCounter();
-				dumpMemory(memptr);
-			}
-		}
-		if (SCRptr->IAR == getBreakPoint() && !halt) {
-			halt = 1;
-			printInstCounter();
-			dumpMemory(memptr);
-		}
-		if (!halt) {
-			fetch();
-			iocycle();
+	// GUI stays on the main thread, SDL wants its events polled there
+	gui_init();
+	if (emuStart()) {
+		gui_close();
+		logend();
+		return 1;
+	}
+	perfStart();
+
+	int close = 0;
+	while(!close && !emuQuitSignal) {
+		uint64_t ticks = SDL_GetTicks64();
+		HPROF_ENTER(HPROF_GUI);
+		close = gui_update();
+		HPROF_LEAVE(HPROF_GUI);
+		uint64_t elapsed = SDL_GetTicks64() - ticks;
+		if (elapsed < 16) {
+			SDL_Delay(16 - elapsed);
 		}
-		//SDL_Delay(1000 / 60);
 	}
 
+	perfStop();
+	emuStop();
+	hostprofSummary(getEmuTime());
+	screenrecStop();
+	shmexportStop();
+	traceStop();
+	profileStop();
+	coverageStop();
+	timelineStop();
 	logend();
 	gui_close();
 	return 0;
-}
\ No newline at end of file
+#endif
+}
@@ -18,18 +18,76 @@ void initMDA (struct structmda* currmda, struct ioBusStruct* ioBusPointer, uint3
 	currmda->memAddress = memaddr;
 	currmda->memAddressMask = memaddrMask;
 	ioBusPtr = ioBusPointer;
+	ioMapMemWindow(memaddr, MDA_MEMSIZE, currmda->videoMem, mdaMemWritten, currmda);
+}
+
+// Bump the generation of the displayed rows covering changed video memory.
+// Also the write hook for direct accesses from the MMU.
+void mdaMemWritten (void* ctx, uint32_t offset, uint8_t len) {
+	struct structmda* currmda = ctx;
+	for (uint32_t i = (offset >> 1); i <= ((offset + len - 1) >> 1); i++) {
+		uint16_t cell = (i - currmda->startAddr) & ((MDA_MEMSIZE >> 1) - 1);
+		if (cell < (MDA_COLS * MDA_ROWS)) {
+			currmda->rowGen[cell / MDA_COLS]++;
+			currmda->screenGen++;
+		}
+	}
+}
+
+void markAllRowsDirty (struct structmda* currmda) {
+	for (int i = 0; i < MDA_ROWS; i++) {
+		currmda->rowGen[i]++;
+	}
+	currmda->screenGen++;
+}
+
+// Returns the cell index (0-1999) of the cursor, or -1 if it is off screen.
+int getMDACursor (struct structmda* currmda) {
+	uint16_t cursor = (currmda->crtcRegs[CRTC_CursorH] << 8) | currmda->crtcRegs[CRTC_CursorL];
+	uint16_t cell = (cursor - currmda->startAddr) & ((MDA_MEMSIZE >> 1) - 1);
+	if (cell >= (MDA_COLS * MDA_ROWS)) {return -1;}
+	return cell;
+}
+
+void writeCRTC (struct structmda* currmda, uint8_t data) {
+	if (currmda->crtcAddr >= sizeof(currmda->crtcRegs)) {
+		logmsgf(LOGMDA, "MDA: Error write to invalid CRTC Reg %d\n", currmda->crtcAddr);
+		return;
+	}
+	logmsgf(LOGMDA, "MDA: Write CRTC R%d 0x%02X\n", currmda->crtcAddr, data);
+	currmda->crtcRegs[currmda->crtcAddr] = data;
+	switch (currmda->crtcAddr) {
+		case CRTC_StartAddrH:
+		case CRTC_StartAddrL:
+			// Whole screen moves
+			currmda->startAddr = ((currmda->crtcRegs[CRTC_StartAddrH] & 0x3F) << 8) | currmda->crtcRegs[CRTC_StartAddrL];
+			markAllRowsDirty(currmda);
+			break;
+	}
+}
+
+uint8_t readCRTC (struct structmda* currmda) {
+	// Only the cursor and light pen registers can be read back
+	if (currmda->crtcAddr >= CRTC_CursorH && currmda->crtcAddr <= CRTC_LightPenL) {
+		return currmda->crtcRegs[currmda->crtcAddr];
+	}
+	return 0;
 }
 
 void writeMDAregs (struct structmda* currmda) {
 	if (ioBusPtr->addr == 0x0003B8) {
 		logmsgf(LOGMDA, "MDA: Write Control Reg 0x%04X\n", ioBusPtr->data);
+		if ((currmda->ctrlReg ^ ioBusPtr->data) & (MDACTRL_VideoEnable | MDACTRL_Blink)) {
+			markAllRowsDirty(currmda);
+		}
 		currmda->ctrlReg = (ioBusPtr->data & 0x00FF);
 	} else if ((ioBusPtr->addr & 0x000009) == 0x000000) {
 		// CRTC Address Reg 0x3B4 (or 0x3B0,2,4,6)
 		logmsgf(LOGMDA, "MDA: Write CRTC addr Reg 0x%04X\n", ioBusPtr->data);
+		currmda->crtcAddr = (ioBusPtr->data & 0x001F);
 	} else if ((ioBusPtr->addr & 0x000009) == 0x000001) {
 		// CRTC Register 0x3B5 (or 0x3B1,3,5,7)
-		logmsgf(LOGMDA, "MDA: Write CRTC data Reg 0x%04X\n", ioBusPtr->data);
+		writeCRTC(currmda, ioBusPtr->data & 0x00FF);
 	}
 }
 
@@ -39,21 +97,26 @@ void readMDAregs (struct structmda* currmda) {
 		logmsgf(LOGMDA, "MDA: Read Status Reg 0x%04X\n", ioBusPtr->data);
 	} else if ((ioBusPtr->addr & 0x000009) == 0x000001) {
 		// CRTC Register 0x3B5 (or 0x3B1,3,5,7)
-		logmsgf(LOGMDA, "MDA: Read CRTC data Reg 0x%04X\n", ioBusPtr->data);
+		ioBusPtr->data = readCRTC(currmda);
+		logmsgf(LOGMDA, "MDA: Read CRTC R%d 0x%04X\n", currmda->crtcAddr, ioBusPtr->data);
 	} else {
 		ioBusPtr->data = 0;
 	}
 }
 
 void writeMDAmem (struct structmda* currmda) {
-	if (ioBusPtr->addr >= 0x0B0000 && ioBusPtr->addr <= 0x0B0F9F) {
+	if (ioBusPtr->addr >= 0x0B0000 && ioBusPtr->addr <= 0x0B0FFF) {
 		logmsgf(LOGMDA, "MDA: Write video memory 0x%04X\n", ioBusPtr->data);
-		currmda->videoMem[ioBusPtr->addr & 0x000FFF] = (ioBusPtr->data & 0x00FF);
+		uint16_t offset = ioBusPtr->addr & 0x000FFF;
+		if (currmda->videoMem[offset] != (ioBusPtr->data & 0x00FF)) {
+			currmda->videoMem[offset] = (ioBusPtr->data & 0x00FF);
+			mdaMemWritten(currmda, offset, 1);
+		}
 	}
 }
 
 void readMDAmem (struct structmda* currmda) {
-	if (ioBusPtr->addr >= 0x0B0000 && ioBusPtr->addr <= 0x0B0F9F) {
+	if (ioBusPtr->addr >= 0x0B0000 && ioBusPtr->addr <= 0x0B0FFF) {
 		ioBusPtr->data = currmda->videoMem[ioBusPtr->addr & 0x000FFF];
 		logmsgf(LOGMDA, "MDA: Read video memory 0x%04X\n", ioBusPtr->data);
 	}
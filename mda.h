@@ -4,6 +4,11 @@
 #include <stdint.h>
 #include "iocc.h"
 
+#define MDA_MEMSIZE	4096
+#define MDA_COLS		80
+#define MDA_ROWS		25
+#define MDA_SCANLINES	14	// Scan lines per character row
+
 struct structmda {
 	uint32_t ioAddress;
 	uint32_t ioAddressMask;
@@ -12,9 +17,45 @@ struct structmda {
 	uint8_t reset;
 	uint8_t ctrlReg;
 	uint8_t statusReg;
-	uint8_t videoMem[4000];
+	uint8_t crtcAddr;
+	uint8_t crtcRegs[18];
+	uint16_t startAddr;			// Character (word) offset of the top left cell
+	uint32_t rowGen[MDA_ROWS];	// Bumped whenever a displayed row changes
+	uint32_t screenGen;			// Bumped whenever any displayed row changes
+	uint8_t videoMem[MDA_MEMSIZE];
 };
 
+// 6845 CRTC Registers
+#define CRTC_HorizTotal				0
+#define CRTC_HorizDisplayed		1
+#define CRTC_HorizSyncPos			2
+#define CRTC_SyncWidth				3
+#define CRTC_VertTotal				4
+#define CRTC_VertTotalAdjust	5
+#define CRTC_VertDisplayed		6
+#define CRTC_VertSyncPos			7
+#define CRTC_InterlaceMode		8
+#define CRTC_MaxScanLine			9
+#define CRTC_CursorStart			10
+#define CRTC_CursorEnd				11
+#define CRTC_StartAddrH				12
+#define CRTC_StartAddrL				13
+#define CRTC_CursorH					14
+#define CRTC_CursorL					15
+#define CRTC_LightPenH				16
+#define CRTC_LightPenL				17
+
+#define CURSOR_BlinkMode	0x60
+#define CURSOR_Hidden			0x20
+#define CURSOR_ScanLine		0x1F
+
+// Control Reg
+#define MDACTRL_Blink				0x20
+#define MDACTRL_VideoEnable	0x08
+#define MDACTRL_HiRes				0x01
+
 void initMDA (struct structmda* currmda, struct ioBusStruct* ioBusPointer, uint32_t ioaddr, uint32_t ioaddrMask, uint32_t memaddr, uint32_t memaddrMask);
 void accessMDA (struct structmda* currmda);
+void mdaMemWritten (void* ctx, uint32_t offset, uint8_t len);
+int getMDACursor (struct structmda* currmda);
 #endif
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include "memory.h"
 #include "iocc.h"
 #include "logfac.h"
+#include "perf.h"
+#include "triggers.h"
+#include "hostprof.h"
+#include "timeline.h"
 
 
 struct procBusStruct* procBusPtr;
@@ -23,6 +27,8 @@ uint8_t MEARlocked = 0;
 uint8_t RMDRlocked = 0;
 uint32_t* ICSptr;
 uint8_t lastUsedTLB[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+uint64_t tlbHits;
+uint64_t tlbMisses;
 
 // Lookup tables
 static const uint32_t specsizelookup[16] = {0, 65535, 65535, 65535, 65535, 65535, 65535, 65535, 131071, 262143, 524287, 1048575, 2097151, 4194303, 8388607, 16777215};
@@ -55,6 +61,11 @@ void rominit (const char *file) {
 	}
 }
 
+void getTLBStats (uint64_t* hits, uint64_t* misses) {
+	*hits = tlbHits;
+	*misses = tlbMisses;
+}
+
 uint8_t* mmuinit (uint8_t* memptr, struct procBusStruct* procBus) {
 	memory = memptr;
 	procBusPtr = procBus;
@@ -73,6 +84,7 @@ void loadMEAR(void) {
 void updateMERandMEAR (uint32_t merBit) {
 	// If override tag don't set any exception bits...
 	if (procBusPtr->tag == TAG_OVERRIDE) {return;}
+	if (trigArmed & TRIG_MER) {triggerMER(merBit);}
 	logmsgf(LOGMMU, "MMU: Error MERbits to set: 0x%08X MER: 0x%08X Effective Addr: 0x%08X\n", merBit, iommuregs->MemException, procBusPtr->addr );
 
 	if (procBusPtr->tag == TAG_PROC) {
@@ -199,7 +211,9 @@ int invalidAddrCheck (uint32_t addr, uint32_t end_addr, uint8_t width) {
 }
 
 uint8_t genECC(uint32_t data) {
+	HPROF_ENTER(HPROF_ECC);
 	if ((iommuregs->TranslationCtrl & TRANSCTRLEnblRasDiag) && procBusPtr->rw != RW_LOAD) {
+		HPROF_LEAVE(HPROF_ECC);
 		return iommuregs->RASModeDiag & RMDR_AltChkBits;
 	}
 
@@ -217,6 +231,7 @@ uint8_t genECC(uint32_t data) {
 	uint8_t ECC6 = ECCPat00001100[WIDTH_BYTE0] ^ ECCPat00001100[WIDTH_BYTE1] ^ ECCPat10101010[WIDTH_BYTE2] ^ ECCPat10101010[WIDTH_BYTE3];
 	uint8_t ECC7 = ECCPat00000011[WIDTH_BYTE0] ^ ECCPat00000011[WIDTH_BYTE1] ^ ECCPat01010101[WIDTH_BYTE2] ^ ECCPat01010101[WIDTH_BYTE3];
 
+	HPROF_LEAVE(HPROF_ECC);
 	return (ECC0 << 7) | (ECC1 << 6) | (ECC2 << 5) | (ECC3 << 4) | (ECC4 << 3) | (ECC5 << 2) | (ECC6 << 1) | ECC7;
 }
 
@@ -563,8 +578,11 @@ uint32_t checkTLB (uint32_t segment, uint32_t virtPageIdx, uint8_t TLBNum) {
 	}
 
 	if (!TLBused) {
+		tlbMisses++;
 		logmsgf(LOGMMU, "MMU: Neither TLB0 and TLB1 match. Preforming IPT search.\n");
 		realAddr = findIPT(genAddrTag, TLBNum, virtPageIdx, segment);
+	} else {
+		tlbHits++;
 	}
 
 	if (TLBused == 2) {
@@ -629,6 +647,136 @@ uint32_t translatecheck() {
 	return realAddr;
 }
 
+// Which store a real address lands in, same decode as realread()
+int debugLocate (uint32_t addr, uint32_t* offset) {
+	if (((iommuregs->RAMSpec & RAMSPECSize) == 0 && (iommuregs->ROMSpec & ROMSPECSize) == 0) && addr <= MAXREALADDR) {
+		*offset = addr & 0x0000FFFF;
+		return MEMSPACE_ROM;
+	} else if ((addr >= (ROMSPECStartAddr)) && (addr <= ROMSPECEndAddr) && ((iommuregs->ROMSpec & ROMSPECSize) != 0)) {
+		*offset = (addr - (ROMSPECStartAddr)) & 0x0000FFFF;
+		return MEMSPACE_ROM;
+	} else if ((addr >= (RAMSPECStartAddr)) && (addr <= RAMSPECEndAddr) && ((iommuregs->RAMSpec & RAMSPECSize) != 0) && (addr - (RAMSPECStartAddr)) < MEMORYSIZE) {
+		*offset = addr - (RAMSPECStartAddr);
+		return MEMSPACE_RAM;
+	}
+	return MEMSPACE_NONE;
+}
+
+// Where the ROM currently starts in the real address space
+uint32_t debugROMBase (void) {
+	return ((iommuregs->ROMSpec & ROMSPECSize) != 0) ? ROMSPECStartAddr : 0;
+}
+
+// Debugger access, no ECC checking, MER/MEAR updates, TLB reloads or logging.
+// Unmapped bytes read as 0xFF, returns the number of bytes that were mapped.
+uint32_t debugRealRead (uint32_t addr, uint8_t* buf, uint32_t len) {
+	uint32_t mapped = 0;
+	uint32_t i = 0;
+	while (i < len) {
+		uint32_t offset;
+		uint8_t *src = NULL;
+		uint32_t avail = 0;
+		switch (debugLocate(addr + i, &offset)) {
+			case MEMSPACE_ROM:
+				src = rom + offset;
+				avail = ROMSIZE - offset;
+				break;
+			case MEMSPACE_RAM:
+				src = memory + offset;
+				avail = MEMORYSIZE - offset;
+				break;
+		}
+		uint32_t count = len - i;
+		if (src != NULL) {
+			if (count > avail) {count = avail;}
+			memcpy(buf + i, src, count);
+			mapped += count;
+		} else {
+			// Skip to the next byte, mappings are never smaller than 64K so this is rare
+			count = 1;
+			buf[i] = 0xFF;
+		}
+		i += count;
+	}
+	return mapped;
+}
+
+uint32_t debugRealWord (uint32_t addr) {
+	uint8_t bytes[4];
+	debugRealRead(addr, bytes, 4);
+	return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+// Same lookup as translateaddr() but only reads the TLBs and page tables.
+// Returns 0 and sets realAddr, or -1 if the page isn't mapped.
+int debugTranslate (uint32_t addr, uint32_t* realAddr) {
+	uint32_t segment = iommuregs->_direct[(addr & 0xF0000000) >> 28];
+	int page4k = (iommuregs->TranslationCtrl & TRANSCTRLPageSize) ? 1 : 0;
+	uint32_t realPgMask = page4k ? TLBRealPgNum4K : TLBRealPgNum2K;
+	uint32_t virtPageIdx = page4k ? ((addr & 0x0FFFF000) >> 11) : ((addr & 0x0FFFF800) >> 11);
+	uint32_t pageDisp = page4k ? (addr & 0x00000FFF) : (addr & 0x000007FF);
+	uint32_t TLBNum = virtPageIdx & 0x0000000F;
+
+	if (addr >= IOChanIOMapStartAddr) {return -1;}
+	if ((iommuregs->TranslationCtrl & TRANSCTRLSegReg0VirtEqReal) && (addr & 0xF0000000) == 0) {
+		*realAddr = addr & 0x00FFFFFF;
+		return 0;
+	}
+	if (!(segment & SEGREGPresent)) {return -1;}
+
+	uint32_t segID = (segment & SEGREGSegID) >> 2;
+	uint32_t genAddrTag = ((segID << 17) | (virtPageIdx & 0x0001FFF0));
+	if (iommuregs->TLB0_AddrTagField[TLBNum] == genAddrTag && (iommuregs->TLB0_RealPageNum_VBs_KBs[TLBNum] & TLBValidBit)) {
+		*realAddr = ((iommuregs->TLB0_RealPageNum_VBs_KBs[TLBNum] & realPgMask) << 8) | pageDisp;
+		return 0;
+	}
+	if (iommuregs->TLB1_AddrTagField[TLBNum] == genAddrTag && (iommuregs->TLB1_RealPageNum_VBs_KBs[TLBNum] & TLBValidBit)) {
+		*realAddr = ((iommuregs->TLB1_RealPageNum_VBs_KBs[TLBNum] & realPgMask) << 8) | pageDisp;
+		return 0;
+	}
+
+	// Walk the HAT/IPT like findIPT()
+	uint32_t lookupIdx = ((iommuregs->TranslationCtrl & TRANSCTRLPageSize) >> 4) | (iommuregs->RAMSpec & RAMSPECSize);
+	uint32_t baseAddrHATIPT = page4k ? (iommuregs->TranslationCtrl & TRANSCTRLHATIPTBaseAddr4K) : (iommuregs->TranslationCtrl & TRANSCTRLHATIPTBaseAddr2K);
+	baseAddrHATIPT = baseAddrHATIPT << HATIPTBaseAddrMultLookup[lookupIdx];
+	uint32_t addrBits = page4k ? (virtPageIdx >> 1) : virtPageIdx;
+	uint32_t HATIPTaddr = baseAddrHATIPT + (((addrBits ^ segID) & HATAddrGenMask[lookupIdx]) << 4);
+	uint32_t HATentry = debugRealWord(HATIPTaddr | 0x4);
+	if (HATentry & HATIPT_EmptyBit) {return -1;}
+	HATIPTaddr = baseAddrHATIPT + ((HATentry & HATIPT_HATPtr) >> 12);
+	for (int searchCnt = 0; searchCnt < 8192; searchCnt++) {
+		uint32_t IPTentry = debugRealWord(HATIPTaddr);
+		HATentry = debugRealWord(HATIPTaddr | 0x4);
+		if ((IPTentry & HATIPT_AddrTag) == (genAddrTag | TLBNum)) {
+			*realAddr = (((HATIPTaddr & 0x00001FFF) >> 1) & realPgMask) << 8 | pageDisp;
+			return 0;
+		}
+		if (HATentry & HATIPT_LastBit) {break;}
+		HATIPTaddr = baseAddrHATIPT + ((HATentry & HATIPT_IPTPtr) << 4);
+	}
+	return -1;
+}
+
+// Virtual address version of debugRealRead(), translated a page at a time.
+uint32_t debugVirtRead (uint32_t addr, uint8_t* buf, uint32_t len) {
+	uint32_t pageSize = (iommuregs->TranslationCtrl & TRANSCTRLPageSize) ? 4096 : 2048;
+	uint32_t mapped = 0;
+	uint32_t i = 0;
+	while (i < len) {
+		uint32_t curr = addr + i;
+		uint32_t count = pageSize - (curr & (pageSize - 1));
+		uint32_t realAddr;
+		if (count > (len - i)) {count = len - i;}
+		if (!debugTranslate(curr, &realAddr)) {
+			mapped += debugRealRead(realAddr, buf + i, count);
+		} else {
+			memset(buf + i, 0xFF, count);
+		}
+		i += count;
+	}
+	return mapped;
+}
+
 void procwrite (void) {
 	//logmsgf(LOGMMU, "MMU: Write 0x%08X: 0x%08X  %d, %d\n", procBusPtr->addr, procBusPtr->data, procBusPtr->width, mode);
 	if (procBusPtr->pio == PIO_REAL) {
@@ -650,6 +798,7 @@ void procwrite (void) {
 				iommuregs->_direct[procBusPtr->addr & 0x0000FFFF] = (procBusPtr->data & 0x00000003);
 				logmsgf(LOGMMU, "MMU: Write to R/C bits 0x%08X\n", procBusPtr->data);
 				dispCode = 0xFF;
+				if (trigArmed & TRIG_DISP) {triggerDisp(dispCode);}
 			}
 			switch(procBusPtr->addr & 0x0000FFFF) {
 				case 0x0018:
@@ -705,6 +854,7 @@ void procread (void) {
 				// TODO: Fix this so it only updates the display code when the last read is from rom?
 				//if ((lastAddr >= (ROMSPECStartAddr)) && (lastAddr <= ROMSPECEndAddr) && ((iommuregs->ROMSpec & ROMSPECSize) != 0)) {
 					dispCode = procBusPtr->addr & 0x000000FF;
+					if (trigArmed & TRIG_DISP) {triggerDisp(dispCode);}
 				//}
 			}
 		} else {
@@ -745,8 +895,23 @@ void mmuCycle(void) {
 			}
 		}
 	} else if ((procBusPtr->addr >= IOChanIOMapStartAddr) && (procBusPtr->addr <= IOChanIOMapEndAddr)) {
+		uint8_t prev = perfEnter(PERF_IO);
+		if (trigArmed & TRIG_IO) {triggerIO(procBusPtr->addr);}
+		HPROF_ENTER(HPROF_IOACCESS);
 		ioaccess();
+		HPROF_LEAVE(HPROF_IOACCESS);
+		if (timelineOn) {timelineAdd(procBusPtr->rw ? TL_IOWRITE : TL_IOREAD, procBusPtr->addr, procBusPtr->data, procBusPtr->width);}
+		perfLeave(prev);
 	} else if ((procBusPtr->addr >= IOChanMemMapStartAddr) && (procBusPtr->addr <= IOChanMemMapEndAddr)) {
-		ioaccess();
+		uint8_t prev = perfEnter(PERF_IO);
+		if (trigArmed & TRIG_IO) {triggerIO(procBusPtr->addr);}
+		HPROF_ENTER(HPROF_IOACCESS);
+		// Adapter memory windows are accessed directly
+		if (!ioMemAccess()) {
+			ioaccess();
+			if (timelineOn) {timelineAdd(procBusPtr->rw ? TL_IOWRITE : TL_IOREAD, procBusPtr->addr, procBusPtr->data, procBusPtr->width);}
+		}
+		HPROF_LEAVE(HPROF_IOACCESS);
+		perfLeave(prev);
 	}
 }
\ No newline at end of file
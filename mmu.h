@@ -10,11 +10,22 @@ void realwrite (uint32_t addr, uint32_t data, uint8_t bytes);
 uint32_t realread (uint32_t addr, uint8_t bytes);
 int invalidAddrCheck (uint32_t addr, uint32_t end_addr, uint8_t bytes);
 void mmuCycle (void);
+void getTLBStats (uint64_t* hits, uint64_t* misses);
+int debugLocate (uint32_t addr, uint32_t* offset);
+uint32_t debugROMBase (void);
+uint32_t debugRealRead (uint32_t addr, uint8_t* buf, uint32_t len);
+int debugTranslate (uint32_t addr, uint32_t* realAddr);
+uint32_t debugVirtRead (uint32_t addr, uint8_t* buf, uint32_t len);
 
 #define MMUCONFIGSIZE 65536
 #define ROMSIZE 65536
 #define MAXREALADDR 16777214
 
+// debugLocate() results
+#define MEMSPACE_NONE	0
+#define MEMSPACE_ROM	1
+#define MEMSPACE_RAM	2
+
 // Memory Address Real/Virtual Map pg. 1-35
 #define IOChanIOMapStartAddr	0xF0000000
 #define IOChanIOMapEndAddr		0xF0FFFFFF
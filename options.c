@@ -0,0 +1,91 @@
+// Command Line Options
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "options.h"
+#include "romp.h"
+#include "logfac.h"
+#include "screenrec.h"
+#include "shmexport.h"
+#include "trace.h"
+#include "triggers.h"
+#include "profile.h"
+#include "perf.h"
+#include "symbols.h"
+#include "coverage.h"
+#include "timeline.h"
+
+const struct optionHelp commonHelp[] = {
+	{'r', "screen.rec", "Record MDA screen changes here (replay with tools/mdaplay)", 0},
+	{'s', "shmname", "Export the screen and status to this POSIX shared memory name", 0},
+	{'t', "trace.bin", "Write a binary execution trace here (decode with tools/rttrace)", 0},
+	{'T', "trigger", "Log trigger rule, replaces the built in one, see triggers.h (e.g. inst=1000-2000,window,instr)", 0},
+	{'p', "profile", "Count every instruction, write profile.callgrind and profile.folded at exit", 0},
+	{'S', "samples.txt", "Sample the guest IAR every %llu us, write a report here at exit", PERF_SAMPLEUS},
+	{'L', "labels", "Label map for profiles and samples, lines of hex address and name", 0},
+	{'C', "coverage.txt", "Track executed halfwords, write an annotated ROM disassembly here at exit", 0},
+	{'E', "timeline.json", "Write device accesses and interrupts here as a Chrome trace (ui.perfetto.dev)", 0},
+	{'R', "MB", "Start a new log.txt.n every this many MB, 0 never does (default: %llu)", LOGROTATESIZE / (1024 * 1024)},
+	{'d', NULL, "Drop log messages rather than wait when the log writer falls behind", 0},
+	{0}
+};
+
+// Returns 0 if handled, 1 if it failed (and said why), -1 if it isn't a common option
+int parseCommonOpt (int opt, const char *arg, struct structmda* mdaptr, uint8_t* dispCodeptr) {
+	switch (opt) {
+		case 'r':
+			return screenrecStart(arg, mdaptr) ? 1 : 0;
+		case 's':
+			return shmexportStart(arg, mdaptr, getSCRptr(), dispCodeptr) ? 1 : 0;
+		case 't':
+			return traceStart(arg, getGPRptr(), getSCRptr()->_direct) ? 1 : 0;
+		case 'T':
+			return triggerParse(arg) ? 1 : 0;
+		case 'p':
+			return profileStart(arg, getGPRptr()) ? 1 : 0;
+		case 'S':
+			return perfSampleGuest(arg) ? 1 : 0;
+		case 'L':
+			return symLoad(arg) ? 1 : 0;
+		case 'C':
+			return coverageStart(arg) ? 1 : 0;
+		case 'E':
+			return timelineStart(arg) ? 1 : 0;
+		case 'R':
+			logsetrotate(strtoull(arg, NULL, 0) * 1024 * 1024);
+			return 0;
+		case 'd':
+			logsetfullpolicy(LOGFULL_DROP);
+			return 0;
+	}
+	return -1;
+}
+
+void printOpts (const struct optionHelp* opts) {
+	for (; opts && opts->opt; opts++) {
+		if (opts->arg) {
+			fprintf(stderr, " [-%c %s]", opts->opt, opts->arg);
+		} else {
+			fprintf(stderr, " [-%c]", opts->opt);
+		}
+	}
+}
+
+void printHelp (const struct optionHelp* opts) {
+	for (; opts && opts->opt; opts++) {
+		fprintf(stderr, "  -%c  ", opts->opt);
+		fprintf(stderr, opts->help, (unsigned long long)opts->value);
+		fprintf(stderr, "\n");
+	}
+}
+
+// extra is the caller's own options, listed first
+void optionsUsage (const char *name, const struct optionHelp* extra) {
+	fprintf(stderr, "Usage: %s", name);
+	printOpts(extra);
+	printOpts(commonHelp);
+	fprintf(stderr, "\n");
+	printHelp(extra);
+	printHelp(commonHelp);
+}
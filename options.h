@@ -0,0 +1,22 @@
+// Command Line Options
+#ifndef _OPTIONS
+#define _OPTIONS
+#include <stdint.h>
+#include "defs.h"
+#include "mda.h"
+
+// Options both the GUI and headless builds take, for getopt()
+#define COMMONOPTS	"r:s:t:T:p:S:L:C:E:R:d"
+
+// One usage line, help may have a %llu for value
+struct optionHelp {
+	char opt;
+	const char *arg;	// NULL if it takes none
+	const char *help;
+	uint64_t value;
+};
+
+int parseCommonOpt (int opt, const char *arg, struct structmda* mdaptr, uint8_t* dispCodeptr);
+void optionsUsage (const char *name, const struct optionHelp* extra);
+
+#endif
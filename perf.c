@@ -0,0 +1,202 @@
+// Performance Counters
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "perf.h"
+#include "romp.h"
+#include "symbols.h"
+
+_Atomic uint8_t perfSection = PERF_CPU;
+atomic_int perfGUIBusy;
+
+pthread_t perfThread;
+atomic_int perfRunning;
+_Atomic uint64_t sectionSamples[PERF_SECTIONS];
+_Atomic uint64_t guiSamples;
+_Atomic uint64_t totalSamples;
+
+// Guest IAR sampling, the ring belongs to the perf thread until it's joined
+_Atomic uint32_t perfIAR;
+_Atomic uint32_t perfICS;
+char guestFile[256];
+int guestSampling = 0;
+struct perfGuestSample *guestRing = NULL;
+uint64_t guestCount = 0;
+
+void* perfThreadMain (void* arg) {
+	(void)arg;
+	struct timespec period = {0, PERF_SAMPLEUS * 1000};
+	while (atomic_load_explicit(&perfRunning, memory_order_relaxed)) {
+		nanosleep(&period, NULL);
+		uint8_t section = atomic_load_explicit(&perfSection, memory_order_relaxed);
+		atomic_fetch_add_explicit(&sectionSamples[section], 1, memory_order_relaxed);
+		if (atomic_load_explicit(&perfGUIBusy, memory_order_relaxed)) {
+			atomic_fetch_add_explicit(&guiSamples, 1, memory_order_relaxed);
+		}
+		atomic_fetch_add_explicit(&totalSamples, 1, memory_order_relaxed);
+		if (guestSampling) {
+			struct perfGuestSample *sample = &guestRing[guestCount++ & (PERF_GUESTRING - 1)];
+			sample->iar = atomic_load_explicit(&perfIAR, memory_order_relaxed);
+			sample->ics = atomic_load_explicit(&perfICS, memory_order_relaxed);
+			sample->section = section;
+		}
+	}
+	return NULL;
+}
+
+// Record the guest IAR each sample too, reported to file by perfStop()
+int perfSampleGuest (const char *file) {
+	guestRing = malloc(PERF_GUESTRING * sizeof(struct perfGuestSample));
+	if (!guestRing) {
+		printf("Error allocating guest sample ring\n");
+		return -1;
+	}
+	snprintf(guestFile, sizeof(guestFile), "%s", file);
+	guestCount = 0;
+	guestSampling = 1;
+	return 0;
+}
+
+int perfSamplingGuest (void) {
+	return guestSampling;
+}
+
+int compareIAR (const void* a, const void* b) {
+	uint32_t ia = *(const uint32_t*)a;
+	uint32_t ib = *(const uint32_t*)b;
+	return (ia > ib) - (ia < ib);
+}
+
+struct guestHot {
+	uint32_t iar;
+	uint32_t count;
+};
+
+int compareHot (const void* a, const void* b) {
+	uint32_t ca = ((const struct guestHot*)a)->count;
+	uint32_t cb = ((const struct guestHot*)b)->count;
+	return (ca < cb) - (ca > cb);
+}
+
+double percent (uint64_t part, uint64_t total) {
+	return total ? (part * 100.0) / total : 0.0;
+}
+
+void writeGuestReport (FILE* out) {
+	uint64_t kept = (guestCount < PERF_GUESTRING) ? guestCount : PERF_GUESTRING;
+	uint64_t translated = 0, idle = 0;
+	uint64_t level[8] = {0};
+	uint32_t *iars = malloc(kept * sizeof(uint32_t));
+	struct guestHot *hot = malloc(kept * sizeof(struct guestHot));
+	if (kept && (!iars || !hot)) {
+		free(iars);
+		free(hot);
+		return;
+	}
+	uint64_t running = 0;
+	for (uint64_t i=0; i < kept; i++) {
+		struct perfGuestSample *sample = &guestRing[i];
+		if (sample->section == PERF_IDLE) {
+			idle++;
+			continue;
+		}
+		if (sample->ics & ICS_MASK_TranslateMode) {translated++;}
+		level[sample->ics & ICS_MASK_ProcPriority]++;
+		iars[running++] = sample->iar;
+	}
+
+	fprintf(out, "# %llu samples every %d us", (unsigned long long)guestCount, PERF_SAMPLEUS);
+	if (guestCount > kept) {fprintf(out, ", newest %llu kept", (unsigned long long)kept);}
+	fprintf(out, ", %d labels\n", symCount());
+	fprintf(out, "# Waiting %.1f%%, running %llu samples: translate on %.1f%%\n", percent(idle, kept), (unsigned long long)running, percent(translated, running));
+	fprintf(out, "# Priority level:");
+	for (int i=0; i < 8; i++) {
+		fprintf(out, " %d:%.1f%%", i, percent(level[i], running));
+	}
+	fprintf(out, "\n\n");
+
+	// Sorted by address, so every routine's samples are next to each other
+	qsort(iars, running, sizeof(uint32_t), compareIAR);
+	uint64_t nhot = 0;
+	for (uint64_t i=0; i < running; i++) {
+		if (nhot && hot[nhot-1].iar == iars[i]) {
+			hot[nhot-1].count++;
+		} else {
+			hot[nhot].iar = iars[i];
+			hot[nhot].count = 1;
+			nhot++;
+		}
+	}
+	struct guestHot *funcs = malloc(nhot * sizeof(struct guestHot));
+	uint64_t nfuncs = 0;
+	char name[SYMTEXTMAX], prevName[SYMTEXTMAX] = "";
+	for (uint64_t i=0; funcs && i < nhot; i++) {
+		symFunc(hot[i].iar, name, sizeof(name));
+		if (nfuncs && !strcmp(name, prevName)) {
+			funcs[nfuncs-1].count += hot[i].count;
+		} else {
+			funcs[nfuncs].iar = hot[i].iar;
+			funcs[nfuncs].count = hot[i].count;
+			nfuncs++;
+			strcpy(prevName, name);
+		}
+	}
+	fprintf(out, "# samples      %%  routine\n");
+	if (funcs) {
+		qsort(funcs, nfuncs, sizeof(struct guestHot), compareHot);
+		for (uint64_t i=0; i < nfuncs; i++) {
+			fprintf(out, "%9u %6.2f  %s\n", funcs[i].count, percent(funcs[i].count, running), symFunc(funcs[i].iar, name, sizeof(name)));
+		}
+	}
+	fprintf(out, "\n# samples      %%  address\n");
+	qsort(hot, nhot, sizeof(struct guestHot), compareHot);
+	for (uint64_t i=0; i < nhot && i < PERF_REPORTIARS; i++) {
+		fprintf(out, "%9u %6.2f  0x%08X %s\n", hot[i].count, percent(hot[i].count, running), hot[i].iar, symName(hot[i].iar, name, sizeof(name)));
+	}
+	free(funcs);
+	free(hot);
+	free(iars);
+}
+
+int perfStart (void) {
+	atomic_store(&perfRunning, 1);
+	if (pthread_create(&perfThread, NULL, perfThreadMain, NULL)) {
+		printf("Error creating perf sampling thread\n");
+		atomic_store(&perfRunning, 0);
+		return -1;
+	}
+	return 0;
+}
+
+void perfStop (void) {
+	if (!atomic_load(&perfRunning)) {return;}
+	atomic_store(&perfRunning, 0);
+	pthread_join(perfThread, NULL);
+	if (guestSampling) {
+		guestSampling = 0;
+		FILE *out = fopen(guestFile, "w");
+		if (out) {
+			writeGuestReport(out);
+			fclose(out);
+		} else {
+			printf("Error opening %s\n", guestFile);
+		}
+		free(guestRing);
+	}
+}
+
+void perfSetGUIBusy (int busy) {
+	atomic_store_explicit(&perfGUIBusy, busy, memory_order_relaxed);
+}
+
+void perfReadSamples (struct perfSamples* samples) {
+	for (int i=0; i < PERF_SECTIONS; i++) {
+		samples->section[i] = atomic_load_explicit(&sectionSamples[i], memory_order_relaxed);
+	}
+	samples->gui = atomic_load_explicit(&guiSamples, memory_order_relaxed);
+	samples->total = atomic_load_explicit(&totalSamples, memory_order_relaxed);
+}
@@ -0,0 +1,62 @@
+// Performance Counters
+#ifndef _PERF
+#define _PERF
+#include <stdint.h>
+#include <stdatomic.h>
+
+// What the emulation thread is doing, sampled by the perf thread
+#define PERF_CPU			0
+#define PERF_MMU			1
+#define PERF_IO				2
+#define PERF_IDLE			3
+#define PERF_SECTIONS	4
+
+#define PERF_SAMPLEUS	1000	// Sample period
+#define PERF_GUESTRING	(1 << 20)	// Guest IAR samples kept, newest overwrite oldest
+#define PERF_REPORTIARS	64	// Hottest addresses listed in the report
+
+extern _Atomic uint8_t perfSection;
+extern atomic_int perfGUIBusy;
+extern _Atomic uint32_t perfIAR;
+extern _Atomic uint32_t perfICS;
+
+// Cheap enough for the bus paths, a relaxed store each way
+static inline uint8_t perfEnter (uint8_t section) {
+	uint8_t prev = atomic_load_explicit(&perfSection, memory_order_relaxed);
+	atomic_store_explicit(&perfSection, section, memory_order_relaxed);
+	return prev;
+}
+
+static inline void perfLeave (uint8_t prev) {
+	atomic_store_explicit(&perfSection, prev, memory_order_relaxed);
+}
+
+// Guest state for the sampler, a relaxed store per instruction
+static inline void perfSetIAR (uint32_t iar) {
+	atomic_store_explicit(&perfIAR, iar, memory_order_relaxed);
+}
+
+static inline void perfSetICS (uint32_t ics) {
+	atomic_store_explicit(&perfICS, ics, memory_order_relaxed);
+}
+
+struct perfGuestSample {
+	uint32_t iar;
+	uint16_t ics;
+	uint8_t section;
+};
+
+struct perfSamples {
+	uint64_t section[PERF_SECTIONS];
+	uint64_t gui;		// Samples where the GUI thread was busy
+	uint64_t total;
+};
+
+int perfSampleGuest (const char *file);
+int perfSamplingGuest (void);
+int perfStart (void);
+void perfStop (void);
+void perfSetGUIBusy (int busy);
+void perfReadSamples (struct perfSamples* samples);
+
+#endif
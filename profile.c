@@ -0,0 +1,288 @@
+// Exact Execution Profiler
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+#include "romp.h"
+#include "mmu.h"
+#include "symbols.h"
+
+#define PROFBLOCKS	(1 << PROFBLOCKBITS)
+#define PROFNODES		(1 << PROFNODEBITS)
+
+// Straight line run of instructions from start to end in one context
+struct profBlock {
+	uint32_t start;
+	uint32_t end;		// IAR of the last instruction
+	uint32_t node;
+	uint32_t insts;
+	uint64_t count;
+	uint8_t virt;		// Fetched through the MMU
+	uint8_t used;
+};
+
+// Calling context tree, node 0 is the root
+struct profNode {
+	uint32_t func;		// Entry address
+	uint32_t parent;
+	uint32_t callsite;	// IAR of the call into it
+	uint64_t calls;
+	uint64_t self;		// Instructions
+	uint64_t incl;		// Filled in when writing out
+};
+
+struct profFrame {
+	uint32_t ret;
+	uint32_t caller;
+};
+
+int profileOn = 0;
+uint32_t profNext = 0;
+uint32_t profLastIAR = 0;
+uint32_t profLastInst = 0;
+uint32_t profBlockInsts = 0;
+
+char profPrefix[256];
+uint32_t *profGPRptr;
+uint32_t profBlockStart;
+uint8_t profBlockVirt;
+struct profBlock *profBlocks = NULL;
+struct profNode *profNodes = NULL;
+uint32_t *profChildren = NULL;	// Hash of (parent, func) to node + 1
+uint32_t profNodeCount;
+uint32_t profNode;
+struct profFrame profStack[PROFSTACKMAX];
+int profDepth;
+uint64_t profLost;	// Instructions that didn't fit in the block table
+
+int profileStart (const char *prefix, uint32_t* GPRptr) {
+	profBlocks = calloc(PROFBLOCKS, sizeof(struct profBlock));
+	profNodes = calloc(PROFNODES, sizeof(struct profNode));
+	profChildren = calloc(PROFNODES * 2, sizeof(uint32_t));
+	if (!profBlocks || !profNodes || !profChildren) {
+		printf("Error allocating profiler tables\n");
+		return -1;
+	}
+	snprintf(profPrefix, sizeof(profPrefix), "%s", prefix);
+	profGPRptr = GPRptr;
+	profBlockStart = getSCRptr()->IAR;
+	profBlockVirt = (getSCRptr()->ICS & ICS_MASK_TranslateMode) != 0;
+	profNext = profBlockStart;
+	profBlockInsts = 0;
+	profNodes[0].func = profBlockStart;
+	profNodeCount = 1;
+	profNode = 0;
+	profDepth = 0;
+	profLost = 0;
+	profileOn = 1;
+	return 0;
+}
+
+uint32_t hashBlock (uint32_t start, uint32_t end, uint32_t node) {
+	return ((start * 2654435761u) ^ (end * 40503u) ^ (node * 2246822519u)) >> (32 - PROFBLOCKBITS);
+}
+
+void addBlock (uint32_t start, uint32_t end, uint32_t insts) {
+	uint32_t slot = hashBlock(start, end, profNode);
+	for (int probe=0; probe < PROFBLOCKS; probe++) {
+		struct profBlock *block = &profBlocks[slot];
+		if (!block->used) {
+			block->start = start;
+			block->end = end;
+			block->node = profNode;
+			block->insts = insts;
+			block->virt = profBlockVirt;
+			block->used = 1;
+		}
+		if (block->start == start && block->end == end && block->node == profNode) {
+			block->count++;
+			profNodes[profNode].self += insts;
+			return;
+		}
+		slot = (slot + 1) & (PROFBLOCKS - 1);
+	}
+	profLost += insts;
+}
+
+// Context for calling func from the current one, made on first use
+uint32_t childNode (uint32_t func, uint32_t callsite) {
+	uint32_t mask = (PROFNODES * 2) - 1;
+	uint32_t slot = ((profNode * 2654435761u) ^ (func * 40503u)) & mask;
+	while (profChildren[slot]) {
+		uint32_t n = profChildren[slot] - 1;
+		if (profNodes[n].parent == profNode && profNodes[n].func == func) {return n;}
+		slot = (slot + 1) & mask;
+	}
+	// Out of nodes, charge the callee to the caller
+	if (profNodeCount >= PROFNODES) {return profNode;}
+	uint32_t n = profNodeCount++;
+	profNodes[n].func = func;
+	profNodes[n].parent = profNode;
+	profNodes[n].callsite = callsite;
+	profChildren[slot] = n + 1;
+	return n;
+}
+
+void profileJump (uint32_t iar) {
+	if (profBlockInsts) {
+		addBlock(profBlockStart, profLastIAR, profBlockInsts);
+	}
+	profBlockStart = iar;
+	profBlockVirt = (getSCRptr()->ICS & ICS_MASK_TranslateMode) != 0;
+	profBlockInsts = 0;
+
+	uint8_t op = profLastInst >> 24;
+	int link = -1;
+	if (op == 0x8A || op == 0x8B) {
+		link = 15;
+	} else if (op == 0x8C || op == 0x8D || op == 0xEC || op == 0xED) {
+		link = (profLastInst >> 20) & 0xF;
+	}
+	if (link >= 0) {
+		// BAL family, the block just ended is the call
+		if (profDepth < PROFSTACKMAX) {
+			profStack[profDepth].ret = profGPRptr[link];
+			profStack[profDepth].caller = profNode;
+			profDepth++;
+			profNode = childNode(iar, profLastIAR);
+			profNodes[profNode].calls++;
+		}
+		return;
+	}
+	for (int d = profDepth - 1; d >= 0 && d >= profDepth - PROFRETSCAN; d--) {
+		if (profStack[d].ret == iar) {
+			profNode = profStack[d].caller;
+			profDepth = d;
+			return;
+		}
+	}
+}
+
+// Instruction addresses of a block, walked from memory
+int blockAddrs (struct profBlock* block, uint32_t* addrs, int max) {
+	int n = 0;
+	uint32_t addr = block->start;
+	while (n < max && (uint32_t)n < block->insts) {
+		addrs[n++] = addr;
+		uint8_t word[4];
+		if (block->virt) {
+			debugVirtRead(addr, word, 4);
+		} else {
+			debugRealRead(addr, word, 4);
+		}
+		addr += instLength(word[0] << 24);
+	}
+	// Code changed since it ran, charge it all to the start
+	if ((uint32_t)n != block->insts || addrs[n-1] != block->end) {return 0;}
+	return n;
+}
+
+int compareBlockFunc (const void* a, const void* b) {
+	uint32_t fa = profNodes[((const struct profBlock*)a)->node].func;
+	uint32_t fb = profNodes[((const struct profBlock*)b)->node].func;
+	return (fa > fb) - (fa < fb);
+}
+
+int compareNodeCaller (const void* a, const void* b) {
+	uint32_t fa = profNodes[profNodes[*(const uint32_t*)a].parent].func;
+	uint32_t fb = profNodes[profNodes[*(const uint32_t*)b].parent].func;
+	return (fa > fb) - (fa < fb);
+}
+
+void writeCallgrind (FILE* out) {
+	char name[SYMTEXTMAX];
+	fprintf(out, "# callgrind format\nversion: 1\ncreator: rtemu\npositions: instr\nevents: Instructions\n\n");
+
+	// Group blocks and calls by the function they are in
+	uint32_t nblocks = 0;
+	for (uint32_t i=0; i < PROFBLOCKS; i++) {
+		if (profBlocks[i].used) {profBlocks[nblocks++] = profBlocks[i];}
+	}
+	qsort(profBlocks, nblocks, sizeof(struct profBlock), compareBlockFunc);
+	uint32_t *calls = malloc(profNodeCount * sizeof(uint32_t));
+	uint32_t ncalls = 0;
+	for (uint32_t n=1; n < profNodeCount; n++) {calls[ncalls++] = n;}
+	qsort(calls, ncalls, sizeof(uint32_t), compareNodeCaller);
+
+	static uint32_t addrs[1 << 16];
+	uint32_t b = 0, c = 0;
+	while (b < nblocks || c < ncalls) {
+		uint32_t bf = (b < nblocks) ? profNodes[profBlocks[b].node].func : UINT32_MAX;
+		uint32_t cf = (c < ncalls) ? profNodes[profNodes[calls[c]].parent].func : UINT32_MAX;
+		uint32_t func = (bf < cf) ? bf : cf;
+		fprintf(out, "fn=%s\n", symName(func, name, sizeof(name)));
+		for (; b < nblocks && profNodes[profBlocks[b].node].func == func; b++) {
+			struct profBlock *block = &profBlocks[b];
+			int n = blockAddrs(block, addrs, sizeof(addrs) / sizeof(addrs[0]));
+			if (!n) {
+				fprintf(out, "0x%08X %llu\n", block->start, (unsigned long long)(block->count * block->insts));
+			}
+			for (int i=0; i < n; i++) {
+				fprintf(out, "0x%08X %llu\n", addrs[i], (unsigned long long)block->count);
+			}
+		}
+		for (; c < ncalls && profNodes[profNodes[calls[c]].parent].func == func; c++) {
+			struct profNode *node = &profNodes[calls[c]];
+			fprintf(out, "cfn=%s\ncalls=%llu 0x%08X\n", symName(node->func, name, sizeof(name)), (unsigned long long)node->calls, node->func);
+			fprintf(out, "0x%08X %llu\n", node->callsite, (unsigned long long)node->incl);
+		}
+		fprintf(out, "\n");
+	}
+	free(calls);
+}
+
+void writeFolded (FILE* out) {
+	char name[SYMTEXTMAX];
+	uint32_t path[PROFSTACKMAX + 1];
+	for (uint32_t n=0; n < profNodeCount; n++) {
+		if (!profNodes[n].self) {continue;}
+		int depth = 0;
+		for (uint32_t p = n; depth <= PROFSTACKMAX; p = profNodes[p].parent) {
+			path[depth++] = p;
+			if (!p) {break;}
+		}
+		while (depth--) {
+			fprintf(out, "%s%s", symName(profNodes[path[depth]].func, name, sizeof(name)), depth ? ";" : "");
+		}
+		fprintf(out, " %llu\n", (unsigned long long)profNodes[n].self);
+	}
+}
+
+void profileStop (void) {
+	if (!profileOn) {return;}
+	profileOn = 0;
+	if (profBlockInsts) {
+		addBlock(profBlockStart, profLastIAR, profBlockInsts);
+	}
+	// Children are always made after their parents
+	for (uint32_t n = profNodeCount; n-- > 0;) {
+		profNodes[n].incl += profNodes[n].self;
+		if (n) {profNodes[profNodes[n].parent].incl += profNodes[n].incl;}
+	}
+	if (profLost) {
+		printf("Profiler block table full, %llu instructions not counted\n", (unsigned long long)profLost);
+	}
+
+	char file[300];
+	snprintf(file, sizeof(file), "%s.folded", profPrefix);
+	FILE *out = fopen(file, "w");
+	if (out) {
+		writeFolded(out);
+		fclose(out);
+	} else {
+		printf("Error opening %s\n", file);
+	}
+	snprintf(file, sizeof(file), "%s.callgrind", profPrefix);
+	out = fopen(file, "w");
+	if (out) {
+		writeCallgrind(out);
+		fclose(out);
+	} else {
+		printf("Error opening %s\n", file);
+	}
+	free(profBlocks);
+	free(profNodes);
+	free(profChildren);
+}
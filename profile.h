@@ -0,0 +1,38 @@
+// Exact Execution Profiler
+#ifndef _PROFILE
+#define _PROFILE
+#include <stdint.h>
+#include "disasm.h"
+
+// Counts every executed instruction by basic block and calling context and
+// writes <prefix>.callgrind (kcachegrind) and <prefix>.folded (flamegraph.pl)
+// at exit. A block runs from a jump target to the next break in sequential
+// IAR, so the table is touched once per block rather than per instruction.
+// Calls are the BAL family, a return is a jump to the link address of one of
+// the top few frames. Interrupt handlers are charged to whatever they
+// interrupted.
+#define PROFBLOCKBITS	16	// Block table size, log2
+#define PROFNODEBITS	16	// Calling context nodes, log2
+#define PROFSTACKMAX	256
+#define PROFRETSCAN		8	// Frames searched for a return, deeper is a longjmp
+
+extern int profileOn;
+extern uint32_t profNext;
+extern uint32_t profLastIAR;
+extern uint32_t profLastInst;
+extern uint32_t profBlockInsts;
+
+int profileStart (const char *prefix, uint32_t* GPRptr);
+void profileJump (uint32_t iar);
+void profileStop (void);
+
+// Called from fetch() before each instruction is decoded
+static inline void profileStep (uint32_t iar, uint32_t inst) {
+	if (iar != profNext) {profileJump(iar);}
+	profBlockInsts++;
+	profLastIAR = iar;
+	profLastInst = inst;
+	profNext = iar + instLength(inst);
+}
+
+#endif
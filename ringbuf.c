@@ -0,0 +1,71 @@
+// Lock-free Single Producer/Single Consumer Ring Buffer
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "ringbuf.h"
+
+void ringbufInit (struct ringbuf* ring, uint8_t* buffer, uint32_t size) {
+	ring->buffer = buffer;
+	ring->size = size;
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+}
+
+uint32_t ringbufLen (struct ringbuf* ring) {
+	return atomic_load_explicit(&ring->head, memory_order_acquire) - atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+uint32_t ringbufFree (struct ringbuf* ring) {
+	return ring->size - ringbufLen(ring);
+}
+
+// Producer side, all or nothing. Returns -1 if there isn't room for len bytes.
+int ringbufWrite (struct ringbuf* ring, const void* data, uint32_t len) {
+	uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+	if ((ring->size - (head - tail)) < len) {return -1;}
+
+	uint32_t offset = head & (ring->size - 1);
+	uint32_t first = ring->size - offset;
+	if (first > len) {first = len;}
+	memcpy(&ring->buffer[offset], data, first);
+	memcpy(&ring->buffer[0], (const uint8_t*)data + first, len - first);
+
+	atomic_store_explicit(&ring->head, head + len, memory_order_release);
+	return 0;
+}
+
+// Consumer side, all or nothing. Returns -1 if fewer than len bytes are queued.
+int ringbufRead (struct ringbuf* ring, void* data, uint32_t len) {
+	uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	if ((head - tail) < len) {return -1;}
+
+	uint32_t offset = tail & (ring->size - 1);
+	uint32_t first = ring->size - offset;
+	if (first > len) {first = len;}
+	memcpy(data, &ring->buffer[offset], first);
+	memcpy((uint8_t*)data + first, &ring->buffer[0], len - first);
+
+	atomic_store_explicit(&ring->tail, tail + len, memory_order_release);
+	return 0;
+}
+
+// Consumer side, in place. Points data at the queued bytes up to the end of
+// the buffer and returns how many there are, ringbufConsume() when done.
+uint32_t ringbufPeek (struct ringbuf* ring, uint8_t** data) {
+	uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	uint32_t offset = tail & (ring->size - 1);
+	uint32_t len = head - tail;
+	if (len > (ring->size - offset)) {len = ring->size - offset;}
+	*data = &ring->buffer[offset];
+	return len;
+}
+
+void ringbufConsume (struct ringbuf* ring, uint32_t len) {
+	uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	atomic_store_explicit(&ring->tail, tail + len, memory_order_release);
+}
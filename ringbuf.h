@@ -0,0 +1,24 @@
+// Lock-free Single Producer/Single Consumer Ring Buffer
+#ifndef _RINGBUF
+#define _RINGBUF
+#include <stdint.h>
+#include <stdatomic.h>
+
+// head and tail free-run and are masked on access, so the length is
+// always head - tail. Size must be a power of two.
+struct ringbuf {
+	uint8_t *buffer;
+	uint32_t size;
+	_Atomic uint32_t head;	// Only written by the producer
+	_Atomic uint32_t tail;	// Only written by the consumer
+};
+
+void ringbufInit (struct ringbuf* ring, uint8_t* buffer, uint32_t size);
+uint32_t ringbufLen (struct ringbuf* ring);
+uint32_t ringbufFree (struct ringbuf* ring);
+int ringbufWrite (struct ringbuf* ring, const void* data, uint32_t len);
+int ringbufRead (struct ringbuf* ring, void* data, uint32_t len);
+uint32_t ringbufPeek (struct ringbuf* ring, uint8_t** data);
+void ringbufConsume (struct ringbuf* ring, uint32_t len);
+
+#endif
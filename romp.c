@@ -6,6 +6,14 @@
 #include "romp.h"
 #include "mmu.h"
 #include "logfac.h"
+#include "disasm.h"
+#include "perf.h"
+#include "trace.h"
+#include "flightrec.h"
+#include "profile.h"
+#include "coverage.h"
+#include "timeline.h"
+#include "hostprof.h"
 
 uint32_t GPR[16];
 union SCRs SCR;
@@ -13,10 +21,12 @@ union SCRs SCR;
 struct procBusStruct* procBusPtr;
 
 uint32_t wait;
+uint8_t intrptLines;	// Level driven interrupt lines pushed in by the devices
 uint32_t currentIntLevel;
 uint32_t prevICS;
 
 uint32_t instCounter[256];
+uint64_t instCount;	// Instructions executed since init
 
 void printInstCounter(void) {
 	for (int i=0; i < 256; i++) {
@@ -46,7 +56,12 @@ uint32_t procBusCycle(uint32_t addr, uint32_t data, uint8_t width, uint8_t rw, u
 		procBusPtr->pio = pio_override;
 	}
 
+	uint8_t prev = perfEnter(PERF_MMU);
+	HPROF_ENTER(HPROF_MMU);
 	mmuCycle();
+	HPROF_LEAVE(HPROF_MMU);
+	perfLeave(prev);
+	if (traceOn) {traceAccess(procBusPtr, addr, pio_override);}
 
 	return procBusPtr->data;
 }
@@ -54,6 +69,7 @@ uint32_t procBusCycle(uint32_t addr, uint32_t data, uint8_t width, uint8_t rw, u
 uint32_t* procinit (struct procBusStruct* procBusPointer) {
 	procBusPtr = procBusPointer;
 	wait = 0;
+	intrptLines = 0;
 	for (uint8_t i=0; i < 16; i++) {
 		GPR[i] = 0x00000000;
 		SCR._direct[i] = 0x00000000;
@@ -65,6 +81,7 @@ uint32_t* procinit (struct procBusStruct* procBusPointer) {
 	for (int i=0; i < 256; i++) {
 		instCounter[i] = 0;
 	}
+	instCount = 0;
 
 	return &GPR[0];
 }
@@ -73,6 +90,31 @@ union SCRs* getSCRptr (void) {
 	return &SCR;
 }
 
+uint32_t* getGPRptr (void) {
+	return GPR;
+}
+
+int getWaitState (void) {
+	return wait;
+}
+
+uint32_t* getInstCounters (void) {
+	return instCounter;
+}
+
+uint64_t getInstCount (void) {
+	return instCount;
+}
+
+void setIntrptLine (uint8_t line, uint8_t level) {
+	if (timelineOn && (!(intrptLines & line) != !level)) {timelineAdd(TL_INTLINE, line, level, 0);}
+	if (level) {
+		intrptLines |= line;
+	} else {
+		intrptLines &= ~line;
+	}
+}
+
 void lt_eq_gt_flag_check (uint32_t val) {
 	SCR.CS &= 0xFFFFFF0F;
 	if (val == 0x00000000) {
@@ -139,7 +181,7 @@ void checkInterrupt(void) {
 
 	uint32_t intLevel = (SCR.IRB & 0x0000FE00);
 	if (!(SCR.ICS & ICS_MASK_IntMask)) {
-		intLevel |= (procBusPtr->intrpt << 8);
+		intLevel |= ((procBusPtr->intrpt | intrptLines) << 8);
 	}
 	
 	if (intLevel & 0x8000) {
@@ -163,8 +205,10 @@ void checkInterrupt(void) {
 	if ((intLevel < (SCR.ICS & ICS_MASK_ProcPriority)) && !(SCR.ICS & ICS_MASK_IntMask)) {
 		logmsgf(LOGPROC, "PROC: Interrupt hit at level %d below Proc Priority %d.\n", intLevel, SCR.ICS & ICS_MASK_ProcPriority);
 		uint32_t psOffset = intLevel;
+		wait = 0;
 		SCR.IRB |= 0x00008000 >> intLevel;
 		psOffset = PROG_STATUS_0 + (psOffset << 4);
+		uint32_t fromIAR = SCR.IAR;
 		procBusCycle(psOffset, SCR.IAR, WIDTH_WORD, RW_STORE, PIO_REAL);
 		procBusCycle(psOffset+4, SCR.ICS, WIDTH_HALFWORD, RW_STORE, PIO_REAL);
 		procBusCycle(psOffset+6, SCR.CS, WIDTH_HALFWORD, RW_STORE, PIO_REAL);
@@ -172,33 +216,49 @@ void checkInterrupt(void) {
 		SCR.ICS = procBusCycle(psOffset+12, 0, WIDTH_HALFWORD, RW_LOAD, PIO_REAL);
 		SCR.CS = procBusCycle(psOffset+14, 0, WIDTH_HALFWORD, RW_LOAD, PIO_REAL);
 		logmsgf(LOGPROC, "			Regs: IAR: 0x%08X ICS: 0x%08X CS: 0x%08X\n", SCR.IAR, SCR.ICS, SCR.CS);
+		if (timelineOn) {
+			timelineAdd(TL_IRB, SCR.IRB, 0, 0);
+			timelineAdd(TL_ENTRY, fromIAR, SCR.IAR, intLevel);
+		}
 	}
 }
 
 void progcheck (uint32_t PCSBits) {
+	char reason[64];
+	snprintf(reason, sizeof(reason), "Program Check PCS 0x%08X", PCSBits);
+	flightrecDump(reason, 1);
 	currentIntLevel = 0x00008000 >> 7;
 	logmsgf(LOGPROC, "PROC: Error Program Check.\n");
+	wait = 0;
 	SCR.MCSPCS = PCSBits;
+	uint32_t fromIAR = SCR.IAR;
 	procBusCycle(PROG_STATUS_PC, SCR.IAR, WIDTH_WORD, RW_STORE, PIO_REAL);
 	procBusCycle(PROG_STATUS_PC+4, SCR.ICS, WIDTH_HALFWORD, RW_STORE, PIO_REAL);
 	procBusCycle(PROG_STATUS_PC+6, SCR.CS, WIDTH_HALFWORD, RW_STORE, PIO_REAL);
 	SCR.IAR = procBusCycle(PROG_STATUS_PC+8, 0, WIDTH_WORD, RW_LOAD, PIO_REAL);
 	SCR.ICS = procBusCycle(PROG_STATUS_PC+12, 0, WIDTH_HALFWORD, RW_LOAD, PIO_REAL);
 	logmsgf(LOGPROC, "			Regs: IAR: 0x%08X ICS: 0x%08X CS: 0x%08X\n", SCR.IAR, SCR.ICS, SCR.CS);
+	if (timelineOn) {timelineAdd(TL_ENTRY, fromIAR, SCR.IAR, 7);}
 	return;
 }
 
 void machcheck (uint32_t MCSBits) {
+	char reason[64];
+	snprintf(reason, sizeof(reason), "%s MCS 0x%08X", (SCR.ICS & ICS_MASK_CheckStopMask) ? "Machine Check" : "CHECKSTOP", MCSBits);
+	flightrecDump(reason, 1);
 	if (SCR.ICS & ICS_MASK_CheckStopMask) {
 		currentIntLevel = 0x00008000 >> 8;
 		logmsgf(LOGPROC, "PROC: Error Machine Check.\n");
+		wait = 0;
 		SCR.MCSPCS = MCSBits;
+		uint32_t fromIAR = SCR.IAR;
 		procBusCycle(PROG_STATUS_MC, SCR.IAR, WIDTH_WORD, RW_STORE, PIO_REAL);
 		procBusCycle(PROG_STATUS_MC+4, SCR.ICS, WIDTH_HALFWORD, RW_STORE, PIO_REAL);
 		procBusCycle(PROG_STATUS_MC+6, SCR.CS, WIDTH_HALFWORD, RW_STORE, PIO_REAL);
 		SCR.IAR = procBusCycle(PROG_STATUS_MC+8, 0, WIDTH_WORD, RW_LOAD, PIO_REAL);
 		SCR.ICS = procBusCycle(PROG_STATUS_MC+12, 0, WIDTH_HALFWORD, RW_LOAD, PIO_REAL);
 		logmsgf(LOGPROC, "			Regs: IAR: 0x%08X ICS: 0x%08X CS: 0x%08X\n", SCR.IAR, SCR.ICS, SCR.CS);
+		if (timelineOn) {timelineAdd(TL_ENTRY, fromIAR, SCR.IAR, 8);}
 	} else {
 		// TODO: Checkstop!
 		logmsgf(LOGPROC, "PROC: CHECKSTOP.\n");
@@ -209,13 +269,23 @@ void machcheck (uint32_t MCSBits) {
 
 uint32_t fetch (void) {
 	uint32_t inst;
-	// TODO: Interrupt, error, POR to clear wait state.
-	if (wait) {return 1;}
+	// Interrupts and checks clear the wait state
 	checkInterrupt();
+	if (wait) {return 1;}
+	perfSetIAR(SCR.IAR);
 	inst = procBusCycle(SCR.IAR, 0, WIDTH_INST, RW_LOAD, 0);
+	flightrecRecord(instCount, SCR.IAR, inst, GPR[15], SCR.ICS, SCR.CS);
+	if (profileOn) {profileStep(SCR.IAR, inst);}
+	if (coverageOn) {coverageStep(SCR.IAR, inst);}
+	if (traceOn) {traceBegin(SCR.IAR, inst);}
+	HPROF_ENTER(HPROF_DECODE);
 	decode(inst, NORMEXEC);
+	HPROF_LEAVE(HPROF_DECODE);
+	if (traceOn) {traceEnd();}
+	instCount++;
 	if (SCR.ICS != prevICS) {
 		prevICS = SCR.ICS;
+		perfSetICS(SCR.ICS);
 		logmsgf(LOGPROC, "PROC: ICS changed: 0x%08X\n", SCR.ICS);
 	}
 	return 0;
@@ -243,13 +313,24 @@ void decode (uint32_t inst, uint8_t mode) {
 	// Log instruction count, IE how many of each instruction we have executed...
 	instCounter[byte0]++;
 
+	// Illegal opcodes, D and M have never been logged, WAIT has always had one tab
+	if (logEnabled(LOGINSTR) && disasmLegal(inst) && byte0 != 0xB6 && byte0 != 0xE6) {
+		char text[DISASMMAX];
+		if (disasm(inst, text, sizeof(text)) == 4) {
+			logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	%s\n", SCR.IAR, inst, text);
+		} else if (byte0 == 0xF0) {
+			logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X	%s\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, text);
+		} else {
+			logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		%s\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, text);
+		}
+	}
+
 	if (nibble0 < 8) {
 		// JI, X, D-Short format Instructions
 		switch(nibble0) {
 			case 0:
 				if (inst & 0x08000000) {
 					// JB
-					logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		JB %s,%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, getCSname((r1 & 0x7)+8), JI);
 					if (mode == DIRECTEXEC) {
 						progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 						return;
@@ -260,7 +341,6 @@ void decode (uint32_t inst, uint8_t mode) {
 					}
 				} else {
 					// JNB
-					logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		JNB %s,%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, getCSname((r1 & 0x7)+8), JI);
 					if (mode == DIRECTEXEC) {
 						progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 						return;
@@ -273,49 +353,42 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 1:
 				// STCS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		STCS %s+%d,GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, gpr_or_0(r3), r1, r2);
 				logmsgf(LOGINSTR, "			0x%08X + %d: 0x%08X\n", r3_reg_or_0, r1, GPR[r2]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				procBusCycle(r3_reg_or_0 + r1, GPR[r2], WIDTH_BYTE, RW_STORE, 0);
 				break;
 			case 2:
 				// STHS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		STHS %s+%d,GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, gpr_or_0(r3), r1 << 1, r2);
 				logmsgf(LOGINSTR, "			0x%08X + %d: 0x%08X\n", r3_reg_or_0, r1 << 1, GPR[r2]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				procBusCycle(r3_reg_or_0 + (r1 << 1), GPR[r2], WIDTH_HALFWORD, RW_STORE, 0);
 				break;
 			case 3:
 				// STS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		STS %s+%d,GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, gpr_or_0(r3), r1 << 2, r2);
 				logmsgf(LOGINSTR, "			0x%08X + %d: 0x%08X\n", r3_reg_or_0, r1 << 2, GPR[r2]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				procBusCycle(r3_reg_or_0 + (r1 << 2), GPR[r2], WIDTH_WORD, RW_STORE, 0);
 				break;
 			case 4:
 				// LCS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		LCS GPR%d, %s+%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, gpr_or_0(r3), r1);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = procBusCycle(r3_reg_or_0 + r1, 0, WIDTH_BYTE, RW_LOAD, 0);
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X + %d\n", GPR[r2], r3_reg_or_0, r1);
 				break;
 			case 5:
 				// LHAS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		LHAS GPR%d, %s+%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, gpr_or_0(r3), r1 << 1);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = (int16_t)procBusCycle(r3_reg_or_0 + (r1 << 1), 0, WIDTH_HALFWORD, RW_LOAD, 0);;
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X + %d\n", GPR[r2], r3_reg_or_0, r1 << 1);
 				break;
 			case 6:
 				// CAS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CAS GPR%d, GPR%d+%s\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r1, r2, gpr_or_0(r3));
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r1] = GPR[r2]+r3_reg_or_0;
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X + 0x%08X\n", GPR[r1], GPR[r2], r3_reg_or_0);
 				break;
 			case 7:
 				// LS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		LS GPR%d, %s+%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, gpr_or_0(r3), (r1 << 2));
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = procBusCycle(r3_reg_or_0 + (r1 << 2), 0, WIDTH_WORD, RW_LOAD, 0);
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X + %d\n", GPR[r2], r3_reg_or_0, r1 << 2);
@@ -326,7 +399,6 @@ void decode (uint32_t inst, uint8_t mode) {
 		switch(byte0) {
 			case 0x88:
 				// BNB
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BNB %s,%d\n", SCR.IAR, inst, getCSname(r2), sI16 << 1);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -338,7 +410,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x89:
 				// BNBX
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BNBX %s,%d\n", SCR.IAR, inst, getCSname(r2), sI16 << 1);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -352,7 +423,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x8A:
 				// BALA
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BALA 0x%06X\n", SCR.IAR, inst, BA);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -364,7 +434,7 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x8B:
 				// BALAX
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BALAX 0x%06X\n	SUB", SCR.IAR, inst, BA);
+				logmsgf(LOGINSTR, "	SUB");
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -377,7 +447,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x8C:
 				// BALI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BALI GPR%d, %d\n", SCR.IAR, inst, r2, sI16 << 1);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -389,7 +458,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x8D:
 				// BALIX
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BALIX GPR%d, %d\n", SCR.IAR, inst, r2, sI16 << 1);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -402,7 +470,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x8E:
 				// BB
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BB %s,%d\n", SCR.IAR, inst, getCSname(r2), sI16 << 1);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -414,7 +481,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x8F:
 				// BBX
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	BBX %s,%d\n", SCR.IAR, inst, getCSname(r2), sI16 << 1);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -428,7 +494,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x90:
 				// AIS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		AIS GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				arith_result = (int32_t)GPR[r2] + r3;
@@ -440,7 +505,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x91:
 				// INC
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		INC GPR%d, GPR%d+%02X\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] + r3;
@@ -448,7 +512,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x92:
 				// SIS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SIS GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				arith_result = (int32_t)GPR[r2] - r3;
@@ -461,7 +524,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x93:
 				// DEC
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		DEC GPR%d, GPR%d-%02X\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] - r3;
@@ -469,7 +531,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x94:
 				// CIS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CIS GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				algebretic_cmp(GPR[r2], r3);
@@ -477,7 +538,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x95:
 				// CLRSB
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CLRSB SCR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if ((SCR.ICS & ICS_MASK_UnprivState) && ((r2 != 6) || (r2 != 11))) {
 					logmsgf(LOGPROC, "PROC: Error attempt to access SCR%d in unprivilaged state.\n", r2);
@@ -487,10 +547,10 @@ void decode (uint32_t inst, uint8_t mode) {
 				prevVal = SCR._direct[r2];
 				SCR._direct[r2] = SCR._direct[r2] & ~(0x00008000 >> r3);
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X & 0x%08X\n", SCR._direct[r2], prevVal, ~(0x00008000 >> r3));
+				if (timelineOn && r2 == 12) {timelineAdd(TL_IRB, SCR.IRB, 0, 0);}
 				break;
 			case 0x96:
 				// MFS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MFS SCR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if ((SCR.ICS & ICS_MASK_UnprivState) && ((r2 != 6) || (r2 != 11))) {
 					logmsgf(LOGPROC, "PROC: Error attempt to access SCR%d in unprivilaged state.\n", r2);
@@ -502,7 +562,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x97:
 				// SETSB
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SETSB SCR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if ((SCR.ICS & ICS_MASK_UnprivState) && ((r2 != 6) || (r2 != 11))) {
 					logmsgf(LOGPROC, "PROC: Error attempt to access SCR%d in unprivilaged state.\n", r2);
@@ -512,10 +571,10 @@ void decode (uint32_t inst, uint8_t mode) {
 				prevVal = SCR._direct[r2];
 				SCR._direct[r2] = SCR._direct[r2] | (0x00008000 >> r3);
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X | 0x%08X\n", SCR._direct[r2], prevVal, (0x00008000 >> r3));
+				if (timelineOn && r2 == 12) {timelineAdd(TL_IRB, SCR.IRB, 0, 0);}
 				break;
 			case 0x98:
 				// CLRBU
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CLRBU GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] & ~(0x80000000 >> r3);
@@ -524,7 +583,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x99:
 				// CLRBL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CLRBL GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] & ~(0x00008000 >> r3);
@@ -533,7 +591,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x9A:
 				// SETBU
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SETBU GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] | (0x80000000 >> r3);
@@ -542,7 +599,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x9B:
 				// SETBL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SETBL GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] | (0x00008000 >> r3);
@@ -551,7 +607,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x9C:
 				// MFTBIU
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MFTBIU GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & ~(0x80000000 >> r3)) | ((SCR.CS & CS_MASK_TB) << (31 - r3));
@@ -559,7 +614,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x9D:
 				// MFTBIL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MFTBIL GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & ~(0x00008000 >> r3)) | ((SCR.CS & CS_MASK_TB) << (15 - r3));
@@ -567,7 +621,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x9E:
 				// MTTBIU
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MTTBIU GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], (0x80000000 >> r3));
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				SCR.CS = (SCR.CS & CS_MASK_Clear_TB) | (((GPR[r2] & (0x80000000 >> r3)) >> (31 - r3)));
@@ -575,7 +628,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0x9F:
 				// MTTBIL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MTTBIL GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], (0x00008000 >> r3));
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				SCR.CS = (SCR.CS & CS_MASK_Clear_TB) | (((GPR[r2] & (0x00008000 >> r3)) >> (15 - r3)));
@@ -583,7 +635,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xA0:
 				// SARI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SARI GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (uint32_t)((int32_t)GPR[r2] >> r3);
@@ -593,7 +644,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xA1:
 				// SARI16
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SARI16 GPR%d, %d+16\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (uint32_t)((int32_t)GPR[r2] >> (r3+16));
@@ -603,13 +653,11 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xA4:
 				// LIS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		LIS GPR%d, 0x%02X\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = r3;
 				break;
 			case 0xA8:
 				// SRI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SRI GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] >> r3;
@@ -619,7 +667,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xA9:
 				// SRI16
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SRI16 GPR%d, %d+16\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] >> (r3+16);
@@ -629,7 +676,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xAA:
 				// SLI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SLI GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] << r3;
@@ -639,7 +685,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xAB:
 				// SLI16
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SLI16 GPR%d, %d+16\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] << (r3+16);
@@ -649,7 +694,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xAC:
 				// SRPI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SRPI GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2^0x01] = GPR[r2] >> r3;
 				lt_eq_gt_flag_check(GPR[r2^0x01]);
@@ -658,7 +702,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xAD:
 				// SRPI16
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SRPI16 GPR%d, %d+16\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2^0x01] = GPR[r2] >> (r3+16);
 				lt_eq_gt_flag_check(GPR[r2^0x01]);
@@ -667,7 +710,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xAE:
 				// SLPI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SLPI GPR%d, %d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2^0x01] = GPR[r2] << r3;
 				lt_eq_gt_flag_check(GPR[r2^0x01]);
@@ -676,7 +718,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xAF:
 				// SLPI16
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SLPI16 GPR%d, %d+16\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2^0x01] = GPR[r2] << (r3+16);
 				lt_eq_gt_flag_check(GPR[r2^0x01]);
@@ -685,7 +726,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xB0:
 				// SAR
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SAR GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (uint32_t)((int32_t)GPR[r2] >> (GPR[r3] & 0x0000003F));
@@ -695,7 +735,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xB1:
 				// EXTS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		EXTS GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = GPR[r3] & 0x00008000 ? GPR[r3] | 0xFFFF0000 : GPR[r3] & 0x00007FFF;
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -704,7 +743,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xB2:
 				// SF
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SF GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				arith_result = (int32_t)GPR[r3] - (int32_t)GPR[r2];
@@ -717,7 +755,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xB3:
 				// CL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CL GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], GPR[r3]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				logical_cmp(GPR[r2], GPR[r3]);
@@ -725,7 +762,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xB4:
 				// C
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		C GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], GPR[r3]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				algebretic_cmp(GPR[r2], GPR[r3]);
@@ -733,7 +769,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xB5:
 				// MTS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MTS SCR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X\n", GPR[r3]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if ((SCR.ICS & ICS_MASK_UnprivState) && ((r2 != 6) || (r2 != 11))) {
@@ -743,16 +778,15 @@ void decode (uint32_t inst, uint8_t mode) {
 				}
 				if (r2 == 13) {logmsgf(LOGPROC, "PROC: Warning MTS SCR13 is unpredictable. IAR: 0x%08X\n", SCR.IAR);}
 				SCR._direct[r2] = GPR[r3];
+				if (timelineOn && r2 == 12) {timelineAdd(TL_IRB, SCR.IRB, 0, 0);}
 				break;
 			case 0xB6:
 				// D
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				logmsgf(LOGPROC, "PROC: Error D instruction to be implemented. IAR: 0x%08X\n", SCR.IAR);
-				//logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		D GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				break;
 			case 0xB8:
 				// SR
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SR GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				if ( (GPR[r3] & 0x0000003F) > 31) {
@@ -766,7 +800,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xB9:
 				// SRP
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SRP GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if ( (GPR[r3] & 0x0000003F) > 31) {
 					GPR[r2^0x01] = 0;
@@ -779,7 +812,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xBA:
 				// SL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SL GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				if ( (GPR[r3] & 0x0000003F) > 31) {
@@ -793,7 +825,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xBB:
 				// SLP
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SLP GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if ( (GPR[r3] & 0x0000003F) > 31) {
 					GPR[r2^0x01] = 0;
@@ -807,7 +838,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xBC:
 				// MFTB
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MFTB GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & ~(0x80000000 >> (GPR[r3] & 0x0000001F))) | ((SCR.CS & 0x00000001) << (31 - (GPR[r3] & 0x0000001F)));
@@ -815,7 +845,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xBD:
 				// TGTE
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		TGTE GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X >= 0x%08X\n", GPR[r2], GPR[r3]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if (GPR[r2] >= GPR[r3]) {
@@ -824,7 +853,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xBE:
 				// TLT
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		TLT GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X < 0x%08X\n", GPR[r2], GPR[r3]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				if (GPR[r2] < GPR[r3]) {
@@ -833,7 +861,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xBF:
 				// MTTB
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MTTB GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], (0x80000000 >> (GPR[r3] & 0x0000001F)));
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				SCR.CS = (SCR.CS & CS_MASK_Clear_TB) | ((GPR[r2] & (0x80000000 >> (GPR[r3] & 0x0000001F))) >> (31 - (GPR[r3] & 0x0000001F)));
@@ -841,7 +868,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC0:
 				// SVC
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	SVC %s+%d\n", SCR.IAR, inst, gpr_or_0(r3), sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
@@ -858,7 +884,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC1:
 				// AI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	AI GPR%d, GPR%d+%d\n", SCR.IAR, inst, r2, r3, sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				arith_result = (int32_t)GPR[r3] + (int32_t)sI16;
 				GPR[r2] = arith_result & 0x00000000FFFFFFFF;
@@ -870,7 +895,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC2:
 				// CAL16
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	CAL16 GPR%d, %s+%04X\n", SCR.IAR, inst, r2, gpr_or_0(r3), I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				prevVal = GPR[r2];
 				GPR[r2] = (r3_reg_or_0 & 0xFFFF0000) | (((r3_reg_or_0 & 0x0000FFFF) + I16) & 0x0000FFFF);
@@ -878,7 +902,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC3:
 				// OIU
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	OIU GPR%d, GPR%d | 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = GPR[r3] | (I16 << 16);
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -887,7 +910,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC4:
 				// OIL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	OIL GPR%d, GPR%d | 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = GPR[r3] | I16;
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -896,7 +918,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC5:
 				// NILZ
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	NILZ GPR%d, GPR%d & 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = GPR[r3] & I16;
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -905,7 +926,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC6:
 				// NILO
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	NILO GPR%d, GPR%d & 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = GPR[r3] & (0xFFFF0000 | I16);
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -914,7 +934,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC7:
 				// XIL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	XIL GPR%d, GPR%d ^ 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = GPR[r3] ^ I16;
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -923,14 +942,12 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xC8:
 				// CAL
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	CAL GPR%d, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = r3_reg_or_0 + sI16;
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X + 0x%08X\n", GPR[r2], r3_reg_or_0, sI16);
 				break;
 			case 0xC9:
 				// LM
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X		LM GPR%d, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				for (int i = r2; i < 16; i++) {
 					GPR[i] = procBusCycle(r3_reg_or_0 + sI16 + ((i - r2) << 2), 0, WIDTH_WORD, RW_LOAD, 0);
@@ -939,14 +956,12 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xCA:
 				// LHA
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X		LHA GPR%d, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16 << 1);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = (int16_t)procBusCycle(r3_reg_or_0 + (sI16 << 1), 0, WIDTH_HALFWORD, RW_LOAD, 0);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], r3_reg_or_0 + (sI16 << 1));
 				break;
 			case 0xCB:
 				// IOR
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	IOR GPR%d, %s+0x%04X\n", SCR.IAR, inst, r2, gpr_or_0(r3), I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				addr = r3_reg_or_0 + I16;
 				if (addr & 0xFF000000) {
@@ -958,7 +973,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xCC:
 				// TI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	TI GPR%d, 0x%08X\n", SCR.IAR, inst, r3, sI16);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				if (r2 & 0x8) {logmsgf(LOGPROC, "PROC: Warning TI bit8 should be zero. IAR: 0x%08X\n", SCR.IAR);}
@@ -987,21 +1001,18 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xCD:
 				// L
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	L GPR%d, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = procBusCycle(r3_reg_or_0 + sI16, 0, WIDTH_WORD, RW_LOAD, 0);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X + %d\n", GPR[r2], r3_reg_or_0,  sI16);
 				break;
 			case 0xCE:
 				// LC
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	LC GPR%d, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = procBusCycle(r3_reg_or_0 + sI16, 0, WIDTH_BYTE, RW_LOAD, 0);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X + %d\n", GPR[r2], r3_reg_or_0,  sI16);
 				break;
 			case 0xCF:
 				// TSH
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		TSH GPR%d, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16 << 1);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				// TSH is treated as a STORE pg. 11-109
 				GPR[r2] = procBusCycle(r3_reg_or_0 + sI16, 0, WIDTH_TESTSET, RW_STORE, 0);
@@ -1010,7 +1021,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD0:
 				// LPS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	LPS 0x%X, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16);
 				logmsgf(LOGINSTR, "			0x%08X + %d\n", r3_reg_or_0,  sI16);
 				if (SCR.ICS & ICS_MASK_UnprivState) {
 					logmsgf(LOGPROC, "PROC: Error LPS instruction is a privilaged instruction.\n", r2);
@@ -1033,6 +1043,7 @@ void decode (uint32_t inst, uint8_t mode) {
 					SCR.MCSPCS = SCR.MCSPCS & 0x000000FF;
 				}
 				logmsgf(LOGINSTR, "			Regs: IAR: 0x%08X ICS: 0x%08X CS: 0x%08X\n", SCR.IAR, SCR.ICS, SCR.CS);
+				if (timelineOn) {timelineAdd(TL_LPS, SCR.IAR, SCR.ICS, 0);}
 				// TODO: if machine check level, MCS content set to 0
 				// TODO: if bit 10, pending mem operations restarted before instr execution resumed, ECR (SCR 9) contains count and mem addr.
 				// If bit 11, interrupts remain pending until target instr executed
@@ -1043,7 +1054,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD1:
 				// AEI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	AEI GPR%d, GPR%d+%d\n", SCR.IAR, inst, r2, r3, sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				arith_result = (int32_t)GPR[r3] + (int32_t)sI16 + ((SCR.CS & CS_MASK_C0) >> 3);
 				GPR[r2] = arith_result & 0x00000000FFFFFFFF;
@@ -1055,7 +1065,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD2:
 				// SFI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	AFI GPR%d, GPR%d+%d\n", SCR.IAR, inst, r2, r3, sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				arith_result = (int32_t)sI16 - (int32_t)GPR[r3];
 				GPR[r2] = arith_result & 0x00000000FFFFFFFF;
@@ -1067,7 +1076,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD3:
 				// CLI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	CLI GPR%d, %d\n", SCR.IAR, inst, r3, sI16);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r3], sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				if (r2 != 0x0) {logmsgf(LOGPROC, "PROC: Warning CLI Nibble2 should be zero. IAR: 0x%08X\n", SCR.IAR);}
@@ -1076,7 +1084,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD4:
 				// CI
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	CI GPR%d, %d\n", SCR.IAR, inst, r3, sI16);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r3], sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				if (r2 != 0x0) {logmsgf(LOGPROC, "PROC: Warning CI Nibble2 should be zero. IAR: 0x%08X\n", SCR.IAR);}
@@ -1085,7 +1092,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD5:
 				// NIUZ
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	NIUZ GPR%d, GPR%d & 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				prevVal = GPR[r3];
 				GPR[r2] = GPR[r3] & (I16 << 16);
@@ -1095,7 +1101,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD6:
 				// NIUO
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	NIUO GPR%d, GPR%d & 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				prevVal = GPR[r3];
 				GPR[r2] = GPR[r3] & ((I16 << 16) | 0x0000FFFF);
@@ -1105,7 +1110,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD7:
 				// XIU
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	XIU GPR%d, GPR%d & 0x%04X\n", SCR.IAR, inst, r2, r3, I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = GPR[r3] ^ (I16 << 16);
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -1114,14 +1118,12 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xD8:
 				// CAU
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	CAU GPR%d, %s+0x%04X\n", SCR.IAR, inst, r2, gpr_or_0(r3), I16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = r3_reg_or_0 + (I16 << 16);
 				logmsgf(LOGINSTR, "			0x%08X = 0x%08X + 0x%08X\n", GPR[r2], r3_reg_or_0, (I16 << 16));
 				break;
 			case 0xD9:
 				// STM
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	STM %s+%d,GPR%d\n", SCR.IAR, inst, gpr_or_0(r3), sI16, r2);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				for (int i = r2; i < 16; i++) {
 					logmsgf(LOGINSTR, "			0x%08X + 0x%08X + %d, 0x%08X\n", r3_reg_or_0, I16, ((i - r2) << 2), GPR[i]);
@@ -1130,14 +1132,12 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xDA:
 				// LH
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	LH GPR%d, %s+%d\n", SCR.IAR, inst, r2, gpr_or_0(r3), sI16);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				GPR[r2] = procBusCycle(r3_reg_or_0 + sI16, 0, WIDTH_HALFWORD, RW_LOAD, 0);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X + 0x%08X\n", GPR[r2], r3_reg_or_0, sI16);
 				break;
 			case 0xDB:
 				// IOW
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	IOW %s+0x%04X, GPR%d\n", SCR.IAR, inst, gpr_or_0(r3), I16, r2);
 				logmsgf(LOGINSTR, "			0x%08X + 0x%08X, 0x%08X\n", r3_reg_or_0, I16, GPR[r2]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				addr = r3_reg_or_0 + I16;
@@ -1149,28 +1149,24 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xDC:
 				// STH
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	STH %s+%d,GPR%d\n", SCR.IAR, inst, gpr_or_0(r3), sI16, r2);
 				logmsgf(LOGINSTR, "			0x%08X + %d, 0x%08X\n", r3_reg_or_0, sI16, GPR[r2]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				procBusCycle(r3_reg_or_0 + sI16, GPR[r2], WIDTH_HALFWORD, RW_STORE, 0);
 				break;
 			case 0xDD:
 				// ST
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	ST %s+%d,GPR%d\n", SCR.IAR, inst, gpr_or_0(r3), sI16, r2);
 				logmsgf(LOGINSTR, "			0x%08X + %d, 0x%08X\n", r3_reg_or_0, sI16, GPR[r2]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				procBusCycle(r3_reg_or_0 + sI16, GPR[r2], WIDTH_WORD, RW_STORE, 0);
 				break;
 			case 0xDE:
 				// STC
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%08X	STC %s+%d,GPR%d\n", SCR.IAR, inst, gpr_or_0(r3), sI16, r2);
 				logmsgf(LOGINSTR, "			0x%08X + %d, 0x%08X\n", r3_reg_or_0, sI16, GPR[r2]);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+4; }
 				procBusCycle(r3_reg_or_0 + sI16, GPR[r2], WIDTH_BYTE, RW_STORE, 0);
 				break;
 			case 0xE0:
 				// ABS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		ABS GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				SCR.CS &= CS_MASK_Clear_OV;
 				SCR.CS &= CS_MASK_Clear_C0;
@@ -1187,7 +1183,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xE1:
 				// A
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		A GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				arith_result = (int32_t)GPR[r2] + (int32_t)GPR[r3];
@@ -1200,7 +1195,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xE2:
 				// S
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		S GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				arith_result = (int32_t)GPR[r2] - (int32_t)GPR[r3];
@@ -1213,7 +1207,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xE3:
 				// O
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		O GPR%d, GPR%d | GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] | GPR[r3];
@@ -1223,7 +1216,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xE4:
 				// TWOC
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		TWOC GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = ~GPR[r3] + 1;
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -1232,7 +1224,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xE5:
 				// N
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		N GPR%d, GPR%d & GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] & GPR[r3];
@@ -1244,11 +1235,9 @@ void decode (uint32_t inst, uint8_t mode) {
 				// M
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				logmsgf(LOGPROC, "PROC: Error M instruction to be implemented. IAR: 0x%08X\n", SCR.IAR);
-				//logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		M GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				break;
 			case 0xE7:
 				// X
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		X GPR%d, GPR%d ^ GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = GPR[r2] ^ GPR[r3];
@@ -1258,7 +1247,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xE8:
 				// BNBR
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X	BNBR %s,GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, getCSname(r2), r3);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -1270,7 +1258,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xE9:
 				// BNBRX
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X	BNBRX %s,GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, getCSname(r2), r3);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -1284,14 +1271,12 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xEB:
 				// LHS
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		LHS GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = procBusCycle(GPR[r3], 0, WIDTH_HALFWORD, RW_LOAD, 0);
 				logmsgf(LOGINSTR, "			0x%08X, 0x%08X\n", GPR[r2], GPR[r3]);
 				break;
 			case 0xEC:
 				// BALR
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		BALR GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -1303,7 +1288,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xED:
 				// BALRX
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		BALRX GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -1316,7 +1300,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xEE:
 				// BBR
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X	BBR %s,GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, getCSname(r2), r3);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -1328,7 +1311,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xEF:
 				// BBRX
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X	BBRX %s,GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, getCSname(r2), r3);
 				if (mode == DIRECTEXEC) {
 					progcheck(PCS_MASK_PCKnownOrig | PCS_MASK_IllegalOpCode);
 					return;
@@ -1342,7 +1324,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xF0:
 				// WAIT
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X	WAIT\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, getCSname(r2), r3);
 				if (SCR.ICS & ICS_MASK_UnprivState) {
 					logmsgf(LOGPROC, "PROC: Error WAIT instruction is a privilaged instruction.\n", r2);
 					progcheck(PCS_MASK_PrivInstExcp);
@@ -1357,7 +1338,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xF1:
 				// AE
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		AE GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				arith_result = (int32_t)GPR[r2] + (int32_t)GPR[r3] + ((SCR.CS & CS_MASK_C0) >> 3);
@@ -1370,7 +1350,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xF2:
 				// SE
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		SE GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				arith_result = (int32_t)GPR[r2] + (int32_t)(~GPR[r3]) + ((SCR.CS & CS_MASK_C0) >> 3);
 				GPR[r2] = arith_result & 0x00000000FFFFFFFF;
@@ -1382,7 +1361,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xF3:
 				// CA16
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CA16 GPR%d, GPR%d+GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r3] & 0xFFFF0000) | (GPR[r2] & 0x0000FFFF) + (GPR[r3] & 0x0000FFFF);
@@ -1390,7 +1368,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xF4:
 				// ONEC
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		ONEC GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				GPR[r2] = ~GPR[r3];
 				lt_eq_gt_flag_check(GPR[r2]);
@@ -1398,7 +1375,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xF5:
 				// CLZ
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		CLZ GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				for (int i = 0; i < 16; i++) {
 					if ( ~GPR[r3] & (0x00008000 >> i) ) {
@@ -1410,7 +1386,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xF9:
 				// MC03
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MC03 GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & 0x00FFFFFF) | ((GPR[r3] & 0x000000FF) << 24);
@@ -1418,7 +1393,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xFA:
 				// MC13
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MC13 GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & 0xFF00FFFF) | ((GPR[r3] & 0x000000FF) << 16);
@@ -1426,7 +1400,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xFB:
 				// MC23
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MC23 GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & 0xFFFF00FF) | ((GPR[r3] & 0x000000FF) << 8);
@@ -1434,7 +1407,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xFC:
 				// MC33
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MC33 GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & 0xFFFFFF00) | GPR[r3] & 0x000000FF;
@@ -1442,7 +1414,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xFD:
 				// MC30
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MC30 GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & 0xFFFFFF00) | ((GPR[r3] & 0xFF000000) >> 24);
@@ -1450,7 +1421,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xFE:
 				// MC31
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MC31 GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & 0xFFFFFF00) | ((GPR[r3] & 0x00FF0000) >> 16);
@@ -1458,7 +1428,6 @@ void decode (uint32_t inst, uint8_t mode) {
 				break;
 			case 0xFF:
 				// MC32
-				logmsgf(LOGINSTR, "INSTR: 0x%08X: 0x%04X		MC32 GPR%d, GPR%d\n", SCR.IAR, (inst & 0xFFFF0000) >> 16, r2, r3);
 				if (mode == NORMEXEC) { SCR.IAR = SCR.IAR+2; }
 				prevVal = GPR[r2];
 				GPR[r2] = (GPR[r2] & 0xFFFFFF00) | ((GPR[r3] & 0x0000FF00) >> 8);
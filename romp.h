@@ -96,6 +96,11 @@ struct OldPS {
 void printInstCounter(void);
 uint32_t* procinit (struct procBusStruct* procBusPointer);
 union SCRs* getSCRptr (void);
+uint32_t* getGPRptr (void);
+int getWaitState (void);
+uint64_t getInstCount (void);
+uint32_t* getInstCounters (void);
+void setIntrptLine (uint8_t line, uint8_t level);
 void checkInterrupt(void);
 void progcheck (uint32_t PCSBits);
 void machcheck (uint32_t PCSBits);
@@ -27,7 +27,6 @@ struct structrtc {
 			uint8_t rtcMem[50];
 		};
 	};
-	uint64_t prevus;
 	uint8_t sqwOut;
 	uint8_t intReq;
 };
@@ -48,5 +47,5 @@ struct structrtc {
 
 void initRTC (struct structrtc* currrtc, struct ioBusStruct* ioBusPointer, uint32_t ioaddr, uint32_t ioaddrMask);
 void accessRTC (struct structrtc* currrtc);
-void cycleRTC (struct structrtc* currrtc);
+void eventRTC (struct structrtc* currrtc);
 #endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+// MDA Screen Recorder
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "defs.h"
+#include "screenrec.h"
+#include "mda.h"
+#include "romp.h"
+#include "varint.h"
+
+int screenrecOn = 0;
+uint64_t screenrecNext = 0;
+FILE *recfile = NULL;
+struct structmda *recMDAptr;
+// Screen as last recorded, glyph/attr pairs in display order
+uint8_t recScreen[MDA_ROWS][MDA_COLS*2];
+uint32_t recRowGen[MDA_ROWS];
+uint32_t recScreenGen;
+int recCursor;
+uint64_t recInstCount;
+
+int screenrecStart (const char *file, struct structmda* mdaptr) {
+	recfile = fopen(file, "wb");
+	if (!recfile) {
+		printf("Error opening screen recording %s\n", file);
+		return -1;
+	}
+	recMDAptr = mdaptr;
+	memset(recScreen, 0, sizeof(recScreen));
+	// Force every row to be compared on the first frame
+	for (int i=0; i < MDA_ROWS; i++) {
+		recRowGen[i] = mdaptr->rowGen[i] - 1;
+	}
+	recScreenGen = mdaptr->screenGen - 1;
+	recCursor = -1;
+	recInstCount = 0;
+	fwrite(SCREENREC_MAGIC, 1, SCREENREC_MAGICLEN, recfile);
+	fputc(MDA_COLS, recfile);
+	fputc(MDA_ROWS, recfile);
+	screenrecNext = getEmuTime();
+	screenrecOn = 1;
+	return 0;
+}
+
+// Diff one row against what was last recorded, returns 1 if it changed
+int diffRow (int row, uint8_t* cells, int* first, int* last) {
+	for (int col=0; col < MDA_COLS; col++) {
+		uint16_t cell = (recMDAptr->startAddr + (row * MDA_COLS) + col) & ((MDA_MEMSIZE >> 1) - 1);
+		cells[col*2] = recMDAptr->videoMem[cell << 1];
+		cells[(col*2)+1] = recMDAptr->videoMem[(cell << 1) + 1];
+	}
+	*first = -1;
+	for (int col=0; col < MDA_COLS; col++) {
+		if (cells[col*2] != recScreen[row][col*2] || cells[(col*2)+1] != recScreen[row][(col*2)+1]) {
+			if (*first < 0) {*first = col;}
+			*last = col;
+		}
+	}
+	return *first >= 0;
+}
+
+void screenrecFrame (void) {
+	screenrecNext = getEmuTime() + SCREENREC_FRAMETIME;
+	int cursor = getMDACursor(recMDAptr);
+	if (recMDAptr->screenGen == recScreenGen && cursor == recCursor) {return;}
+	recScreenGen = recMDAptr->screenGen;
+
+	uint8_t cells[MDA_ROWS][MDA_COLS*2];
+	int first[MDA_ROWS], last[MDA_ROWS];
+	int spans = 0;
+	for (int row=0; row < MDA_ROWS; row++) {
+		first[row] = -1;
+		if (recRowGen[row] == recMDAptr->rowGen[row]) {continue;}
+		recRowGen[row] = recMDAptr->rowGen[row];
+		spans += diffRow(row, cells[row], &first[row], &last[row]);
+	}
+	// Rewritten with the same contents, nothing to record
+	if (!spans && cursor == recCursor) {return;}
+	recCursor = cursor;
+
+	uint64_t instCount = getInstCount();
+	varintWrite(recfile, instCount - recInstCount);
+	recInstCount = instCount;
+	uint16_t cursorCell = (cursor < 0) ? SCREENREC_NOCURSOR : cursor;
+	fputc(cursorCell & 0xFF, recfile);
+	fputc(cursorCell >> 8, recfile);
+	fputc(spans, recfile);
+	for (int row=0; row < MDA_ROWS; row++) {
+		if (first[row] < 0) {continue;}
+		int len = last[row] - first[row] + 1;
+		fputc(row, recfile);
+		fputc(first[row], recfile);
+		fputc(len, recfile);
+		fwrite(&cells[row][first[row]*2], 2, len, recfile);
+		memcpy(&recScreen[row][first[row]*2], &cells[row][first[row]*2], len*2);
+	}
+}
+
+void screenrecStop (void) {
+	if (!screenrecOn) {return;}
+	screenrecFrame();
+	screenrecOn = 0;
+	fclose(recfile);
+	recfile = NULL;
+}
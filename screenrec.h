@@ -0,0 +1,36 @@
+// MDA Screen Recorder
+#ifndef _SCREENREC
+#define _SCREENREC
+#include <stdint.h>
+#include "events.h"
+
+// Recording format, integers little endian:
+//  Header: "MDAREC01", cols (u8), rows (u8)
+//  Frame:  inst count delta since the last frame (LEB128 varint),
+//          cursor cell (u16, 0xFFFF if off screen), changed row spans (u8)
+//  Span:   row (u8), first col (u8), cells (u8), then cells * (glyph, attr)
+// The player starts from an all zero screen.
+#define SCREENREC_MAGIC			"MDAREC01"
+#define SCREENREC_MAGICLEN	8
+#define SCREENREC_NOCURSOR	0xFFFF
+
+// Check the MDA for changes once per emulated 60Hz frame
+#define SCREENREC_FRAMETIME	(16667 * NS_PER_US)
+
+struct structmda;
+
+extern int screenrecOn;
+extern uint64_t screenrecNext;
+
+int screenrecStart (const char *file, struct structmda* mdaptr);
+void screenrecFrame (void);
+void screenrecStop (void);
+
+// Called from the emulation loop, one compare while recording
+static inline void screenrecPoll (void) {
+	if (screenrecOn && getEmuTime() >= screenrecNext) {
+		screenrecFrame();
+	}
+}
+
+#endif
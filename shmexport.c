@@ -0,0 +1,99 @@
+// Shared Memory Screen/Status Export
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "defs.h"
+#include "shmexport.h"
+#include "mda.h"
+#include "romp.h"
+
+int shmexportOn = 0;
+uint64_t shmexportNext = 0;
+struct shmExport *shmptr = NULL;
+char shmName[256];
+struct structmda *shmMDAptr;
+union SCRs *shmSCRptr;
+uint8_t *shmDispCodeptr;
+int shmHalted = 0;
+uint32_t shmScreenGen;
+
+int shmexportStart (const char *name, struct structmda* mdaptr, union SCRs* SCRptr, uint8_t* dispCodeptr) {
+	// shm_open wants a leading slash
+	snprintf(shmName, sizeof(shmName), "%s%s", (name[0] == '/') ? "" : "/", name);
+	int fd = shm_open(shmName, O_CREAT | O_RDWR, 0644);
+	if (fd < 0) {
+		printf("Error creating shared memory %s\n", shmName);
+		return -1;
+	}
+	if (ftruncate(fd, sizeof(struct shmExport))) {
+		printf("Error sizing shared memory %s\n", shmName);
+		close(fd);
+		return -1;
+	}
+	shmptr = mmap(NULL, sizeof(struct shmExport), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (shmptr == MAP_FAILED) {
+		printf("Error mapping shared memory %s\n", shmName);
+		shmptr = NULL;
+		return -1;
+	}
+	shmMDAptr = mdaptr;
+	shmSCRptr = SCRptr;
+	shmDispCodeptr = dispCodeptr;
+	shmScreenGen = mdaptr->screenGen - 1;
+	memset(shmptr, 0, sizeof(struct shmExport));
+	memcpy(shmptr->magic, SHMEXPORT_MAGIC, SHMEXPORT_MAGICLEN);
+	shmptr->pid = getpid();
+	shmexportNext = getEmuTime();
+	shmexportOn = 1;
+	return 0;
+}
+
+void publishExport (uint8_t state) {
+	uint32_t seq = atomic_load_explicit(&shmptr->seq, memory_order_relaxed);
+	atomic_store_explicit(&shmptr->seq, seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	shmptr->instCount = getInstCount();
+	shmptr->emuTime = getEmuTime();
+	shmptr->IAR = shmSCRptr->IAR;
+	shmptr->dispCode = *shmDispCodeptr;
+	shmptr->state = state;
+	int cursor = getMDACursor(shmMDAptr);
+	shmptr->cursor = (cursor < 0) ? SHMEXPORT_NOCURSOR : cursor;
+	shmptr->startAddr = shmMDAptr->startAddr;
+	shmptr->ctrlReg = shmMDAptr->ctrlReg;
+	shmptr->screenGen = shmMDAptr->screenGen;
+	// Video memory only when it changed, the status block is cheap
+	if (shmScreenGen != shmMDAptr->screenGen) {
+		shmScreenGen = shmMDAptr->screenGen;
+		memcpy(shmptr->videoMem, shmMDAptr->videoMem, SHMEXPORT_VIDEOSIZE);
+	}
+
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&shmptr->seq, seq + 2, memory_order_relaxed);
+}
+
+void shmexportFrame (void) {
+	shmexportNext = getEmuTime() + SHMEXPORT_FRAMETIME;
+	publishExport(shmHalted ? SHMSTATE_HALT : (getWaitState() ? SHMSTATE_WAIT : SHMSTATE_RUN));
+}
+
+// Emulated time stops while halted so publish the change right away
+void shmexportSetHalted (int halted) {
+	shmHalted = halted;
+	if (shmexportOn) {shmexportFrame();}
+}
+
+void shmexportStop (void) {
+	if (!shmexportOn) {return;}
+	shmexportOn = 0;
+	publishExport(SHMSTATE_STOPPED);
+	munmap(shmptr, sizeof(struct shmExport));
+	shmptr = NULL;
+	shm_unlink(shmName);
+}
@@ -0,0 +1,58 @@
+// Shared Memory Screen/Status Export
+#ifndef _SHMEXPORT
+#define _SHMEXPORT
+#include <stdint.h>
+#include <stdatomic.h>
+#include "events.h"
+
+// Segment layout, read by external viewers (see tools/shmview.c). Readers
+// retry if seq is odd or changed while they copied, same as emuSeqlock.
+#define SHMEXPORT_MAGIC			"RTSHM001"
+#define SHMEXPORT_MAGICLEN	8
+#define SHMEXPORT_VIDEOSIZE	4096	// MDA_MEMSIZE
+#define SHMEXPORT_NOCURSOR	0xFFFF
+
+#define SHMSTATE_RUN			0
+#define SHMSTATE_WAIT			1
+#define SHMSTATE_HALT			2
+#define SHMSTATE_STOPPED	3	// Emulator exited, segment is stale
+
+// Publish at most once per emulated 60Hz frame
+#define SHMEXPORT_FRAMETIME	(16667 * NS_PER_US)
+
+struct shmExport {
+	char magic[SHMEXPORT_MAGICLEN];
+	_Atomic uint32_t seq;
+	uint32_t pid;
+	uint64_t instCount;
+	uint64_t emuTime;		// ns
+	uint32_t IAR;
+	uint8_t dispCode;		// 0xFF is blank
+	uint8_t state;
+	uint16_t cursor;		// Cell on screen or SHMEXPORT_NOCURSOR
+	uint16_t startAddr;	// Character offset of the top left cell in videoMem
+	uint8_t ctrlReg;
+	uint8_t reserved;
+	uint32_t screenGen;	// Bumped whenever the displayed screen changes
+	uint8_t videoMem[SHMEXPORT_VIDEOSIZE];
+};
+
+struct structmda;
+union SCRs;
+
+extern int shmexportOn;
+extern uint64_t shmexportNext;
+
+int shmexportStart (const char *name, struct structmda* mdaptr, union SCRs* SCRptr, uint8_t* dispCodeptr);
+void shmexportFrame (void);
+void shmexportSetHalted (int halted);
+void shmexportStop (void);
+
+// Called from the emulation loop, one compare while exporting
+static inline void shmexportPoll (void) {
+	if (shmexportOn && getEmuTime() >= shmexportNext) {
+		shmexportFrame();
+	}
+}
+
+#endif
@@ -0,0 +1,101 @@
+// Address to Label Map
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "symbols.h"
+
+struct symEntry {
+	uint32_t addr;
+	char name[SYMNAMEMAX];
+};
+
+struct symEntry *symTable = NULL;
+int symEntries = 0;
+
+int compareSym (const void* a, const void* b) {
+	uint32_t aa = ((const struct symEntry*)a)->addr;
+	uint32_t ab = ((const struct symEntry*)b)->addr;
+	return (aa > ab) - (aa < ab);
+}
+
+int symLoad (const char *file) {
+	FILE *fptr = fopen(file, "r");
+	if (!fptr) {
+		printf("Error opening label map %s\n", file);
+		return -1;
+	}
+	char line[256];
+	int size = 0;
+	while (fgets(line, sizeof(line), fptr)) {
+		char *end;
+		uint32_t addr = strtoul(line, &end, 16);
+		if (line[0] == '#' || end == line) {continue;}
+		while (*end == ' ' || *end == '\t') {end++;}
+		int len = strcspn(end, " \t\r\n");
+		if (!len) {continue;}
+		if (symEntries == size) {
+			size = size ? size * 2 : 1024;
+			struct symEntry *grown = realloc(symTable, size * sizeof(struct symEntry));
+			if (!grown) {break;}
+			symTable = grown;
+		}
+		symTable[symEntries].addr = addr;
+		snprintf(symTable[symEntries].name, SYMNAMEMAX, "%.*s", len, end);
+		symEntries++;
+	}
+	fclose(fptr);
+	qsort(symTable, symEntries, sizeof(struct symEntry), compareSym);
+	return 0;
+}
+
+int symCount (void) {
+	return symEntries;
+}
+
+// Nearest label at or below addr
+struct symEntry* symFind (uint32_t addr) {
+	int lo = 0, hi = symEntries - 1;
+	struct symEntry *found = NULL;
+	while (lo <= hi) {
+		int mid = (lo + hi) / 2;
+		if (symTable[mid].addr <= addr) {
+			found = &symTable[mid];
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return found;
+}
+
+// label+0xoffset, or the bare address with no label below it
+const char* symName (uint32_t addr, char* buf, int size) {
+	struct symEntry *sym = symFind(addr);
+	if (!sym) {
+		snprintf(buf, size, "0x%08X", addr);
+	} else if (sym->addr == addr) {
+		snprintf(buf, size, "%s", sym->name);
+	} else {
+		snprintf(buf, size, "%s+0x%X", sym->name, addr - sym->addr);
+	}
+	return buf;
+}
+
+// Just the label, for grouping samples by routine
+const char* symFunc (uint32_t addr, char* buf, int size) {
+	struct symEntry *sym = symFind(addr);
+	if (!sym) {
+		snprintf(buf, size, "0x%08X", addr);
+	} else {
+		snprintf(buf, size, "%s", sym->name);
+	}
+	return buf;
+}
+
+// The label at exactly addr, NULL if there isn't one
+const char* symLabel (uint32_t addr) {
+	struct symEntry *sym = symFind(addr);
+	return (sym && sym->addr == addr) ? sym->name : NULL;
+}
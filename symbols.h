@@ -0,0 +1,19 @@
+// Address to Label Map
+#ifndef _SYMBOLS
+#define _SYMBOLS
+#include <stdint.h>
+
+// Map file, one label per line: hex address then name, e.g.
+//  008021B2 sysboard_io_test
+// Blank lines and lines starting with # are skipped. Addresses take the
+// nearest label at or below them, as label+0xoffset.
+#define SYMNAMEMAX	48
+#define SYMTEXTMAX	(SYMNAMEMAX + 16)	// Longest symName() result
+
+int symLoad (const char *file);
+int symCount (void);
+const char* symName (uint32_t addr, char* buf, int size);
+const char* symFunc (uint32_t addr, char* buf, int size);
+const char* symLabel (uint32_t addr);
+
+#endif
@@ -0,0 +1,121 @@
+// Device and Interrupt Timeline
+#include <stdio.h>
+#include <stdint.h>
+
+#include "timeline.h"
+#include "defs.h"
+#include "romp.h"
+#include "iocc.h"
+#include "events.h"
+
+#define TL_PID	1
+#define TL_CPU	1	// Thread IDs, just to get separate tracks
+#define TL_IO		2
+
+int timelineOn = 0;
+FILE *timelinefile = NULL;
+struct timelineEvent timelineBuf[TIMELINEBUFSIZE];
+uint32_t timelineLen;
+int timelineDepth;	// Open handler slices, an LPS with none open is shown on its own
+
+const char *timelineEntryNames[9] = {"Level 0", "Level 1", "Level 2", "Level 3", "Level 4", "Level 5", "Level 6", "Program Check", "Machine Check"};
+
+// INTRPT_x bit to its level
+int intrptLevel (uint32_t line) {
+	for (int level=0; level < 8; level++) {
+		if (line & (0x80 >> level)) {return level;}
+	}
+	return 0;
+}
+
+// Chrome's ts is in us, emulated time is in ns
+void writeHead (FILE* out, struct timelineEvent* ev, const char* name, const char* ph, int tid) {
+	fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%llu.%03u,\"pid\":%d,\"tid\":%d", name, ph,
+		(unsigned long long)(ev->time / 1000), (unsigned)(ev->time % 1000), TL_PID, tid);
+}
+
+void writeEvent (FILE* out, struct timelineEvent* ev) {
+	char name[32];
+	switch (ev->kind) {
+		case TL_IOREAD:
+		case TL_IOWRITE:
+			writeHead(out, ev, ioDeviceName(ev->a), "i", TL_IO);
+			fprintf(out, ",\"s\":\"t\",\"cat\":\"io\",\"args\":{\"inst\":%llu,\"%s\":\"0x%08X\",\"data\":\"0x%0*X\"}}", (unsigned long long)ev->inst,
+				(ev->kind == TL_IOWRITE) ? "write" : "read", ev->a, (ev->c == WIDTH_BYTE) ? 2 : ((ev->c == WIDTH_HALFWORD) ? 4 : 8), ev->b);
+			break;
+		case TL_INTLINE:
+			snprintf(name, sizeof(name), "INTRPT %d", intrptLevel(ev->a));
+			writeHead(out, ev, name, "C", TL_CPU);
+			fprintf(out, ",\"args\":{\"level\":%u}}", ev->b);
+			break;
+		case TL_IRLINES:
+			snprintf(name, sizeof(name), "8259 (INTRPT %d) IR", intrptLevel(ev->a));
+			writeHead(out, ev, name, "C", TL_IO);
+			fprintf(out, ",\"args\":{");
+			for (int ir=0; ir < 8; ir++) {
+				fprintf(out, "%s\"IR%d\":%u", ir ? "," : "", ir, (ev->b >> ir) & 1);
+			}
+			fprintf(out, "}}");
+			break;
+		case TL_IRB:
+			writeHead(out, ev, "IRB", "C", TL_CPU);
+			fprintf(out, ",\"args\":{\"IRB\":%u}}", ev->a);
+			break;
+		case TL_ENTRY:
+			timelineDepth++;
+			writeHead(out, ev, timelineEntryNames[(ev->c < 9) ? ev->c : 0], "B", TL_CPU);
+			fprintf(out, ",\"cat\":\"interrupt\",\"args\":{\"inst\":%llu,\"from\":\"0x%08X\",\"handler\":\"0x%08X\"}}", (unsigned long long)ev->inst, ev->a, ev->b);
+			break;
+		case TL_LPS:
+			if (timelineDepth) {
+				timelineDepth--;
+				writeHead(out, ev, "LPS", "E", TL_CPU);
+			} else {
+				writeHead(out, ev, "LPS", "i", TL_CPU);
+				fprintf(out, ",\"s\":\"t\"");
+			}
+			fprintf(out, ",\"args\":{\"inst\":%llu,\"IAR\":\"0x%08X\",\"ICS\":\"0x%04X\"}}", (unsigned long long)ev->inst, ev->a, ev->b);
+			break;
+	}
+}
+
+void timelineFlush (void) {
+	for (uint32_t i=0; i < timelineLen; i++) {
+		writeEvent(timelinefile, &timelineBuf[i]);
+	}
+	timelineLen = 0;
+}
+
+int timelineStart (const char *file) {
+	timelinefile = fopen(file, "w");
+	if (!timelinefile) {
+		printf("Error opening timeline file %s\n", file);
+		return -1;
+	}
+	timelineLen = 0;
+	timelineDepth = 0;
+	fprintf(timelinefile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	fprintf(timelinefile, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"CPU\"}}", TL_PID, TL_CPU);
+	fprintf(timelinefile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"I/O\"}}", TL_PID, TL_IO);
+	timelineOn = 1;
+	return 0;
+}
+
+void timelineStop (void) {
+	if (!timelineOn) {return;}
+	timelineOn = 0;
+	timelineFlush();
+	fprintf(timelinefile, "\n]}\n");
+	fclose(timelinefile);
+}
+
+void timelineAdd (uint8_t kind, uint32_t a, uint32_t b, uint8_t c) {
+	struct timelineEvent *ev = &timelineBuf[timelineLen++];
+	ev->time = getEmuTime();
+	ev->inst = getInstCount();
+	ev->kind = kind;
+	ev->a = a;
+	ev->b = b;
+	ev->c = c;
+	if (timelineLen == TIMELINEBUFSIZE) {timelineFlush();}
+}
@@ -0,0 +1,39 @@
+// Device and Interrupt Timeline
+#ifndef _TIMELINE
+#define _TIMELINE
+#include <stdint.h>
+
+// Chrome trace event JSON (open in ui.perfetto.dev or chrome://tracing),
+// timestamped in emulated time. Events are kept in a buffer as they happen
+// and only formatted when it fills or at exit.
+//  CPU track: interrupt, program and machine check handlers as slices from
+//   entry to the LPS that returns from them.
+//  I/O track: every I/O channel register access, named by adapter.
+//  Counters: processor interrupt lines, each 8259's IR lines and the IRB.
+// The 8237 doesn't transfer anything yet, so DMA shows as its register accesses.
+#define TL_IOREAD		0
+#define TL_IOWRITE	1
+#define TL_INTLINE	2	// a: INTRPT_x, b: level
+#define TL_IRLINES	3	// a: 8259 INT's INTRPT_x, b: IR lines
+#define TL_IRB			4	// a: IRB
+#define TL_ENTRY		5	// a: interrupted IAR, b: handler IAR, c: level (7 PC, 8 MC)
+#define TL_LPS			6	// a: IAR, b: ICS
+
+#define TIMELINEBUFSIZE	16384	// Events held before they're written out
+
+struct timelineEvent {
+	uint64_t time;
+	uint64_t inst;
+	uint32_t a;
+	uint32_t b;
+	uint8_t kind;
+	uint8_t c;
+};
+
+extern int timelineOn;
+
+int timelineStart (const char *file);
+void timelineStop (void);
+void timelineAdd (uint8_t kind, uint32_t a, uint32_t b, uint8_t c);
+
+#endif
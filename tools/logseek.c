@@ -0,0 +1,178 @@
+// Log Instruction Count Seeker
+// Build: cc -o logseek logseek.c
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../logfac.h"
+
+#define INSTRPREFIX	"INSTR: "	// Fetched instructions, execute subjects are " SUBINSTR: "
+
+char *logName;
+int haveCount = 0, haveIAR = 0;
+uint64_t target = 0;
+uint32_t iar = 0;
+uint64_t nth = 1;
+uint64_t lines = 40;
+
+struct logPos {
+	uint32_t segment;
+	uint64_t offset;
+	uint64_t count;		// Instruction count of the next INSTR line
+	int counted;			// count is known
+};
+
+FILE* openSegment (uint32_t segment) {
+	char name[1024];
+	if (segment) {
+		snprintf(name, sizeof(name), "%s.%u", logName, segment);
+	} else {
+		snprintf(name, sizeof(name), "%s", logName);
+	}
+	return fopen(name, "r");
+}
+
+// Last index point at or before count, or the start of the log
+int seekIndex (struct logPos* pos, uint64_t count) {
+	char name[1024];
+	snprintf(name, sizeof(name), "%s%s", logName, LOGINDEXSUFFIX);
+	FILE *index = fopen(name, "r");
+	memset(pos, 0, sizeof(*pos));
+	if (!index) {return -1;}
+	char line[128];
+	unsigned long long indexCount, offset;
+	unsigned segment;
+	while (fgets(line, sizeof(line), index)) {
+		if (sscanf(line, "%llu %u %llu", &indexCount, &segment, &offset) != 3) {continue;}
+		// The first one is always taken, it's where counting starts from
+		if (pos->counted && indexCount > count) {break;}
+		pos->segment = segment;
+		pos->offset = offset;
+		pos->count = indexCount;
+		pos->counted = 1;
+	}
+	fclose(index);
+	return 0;
+}
+
+// Walks lines from pos across segments, stops on the line wanted and leaves
+// pos there. Returns -1 if the log ends first.
+int findLine (struct logPos* pos) {
+	uint64_t seen = 0;
+	char *line = NULL;
+	size_t size = 0;
+	ssize_t len;
+	FILE *log;
+	while ((log = openSegment(pos->segment))) {
+		if (fseek(log, pos->offset, SEEK_SET)) {
+			fclose(log);
+			return -1;
+		}
+		while ((len = getline(&line, &size, log)) > 0) {
+			if (!strncmp(line, INSTRPREFIX, strlen(INSTRPREFIX))) {
+				int match = 1;
+				if (haveCount && pos->counted && pos->count < target) {match = 0;}
+				if (match && haveIAR) {
+					match = (strtoul(line + strlen(INSTRPREFIX), NULL, 16) == iar) && (++seen == nth);
+				}
+				if (match) {
+					fclose(log);
+					free(line);
+					return 0;
+				}
+				pos->count++;
+			}
+			pos->offset += len;
+		}
+		fclose(log);
+		pos->segment++;
+		pos->offset = 0;
+	}
+	free(line);
+	return -1;
+}
+
+void printFrom (struct logPos* pos) {
+	char *line = NULL;
+	size_t size = 0;
+	uint64_t printed = 0;
+	FILE *log;
+	uint64_t offset = pos->offset;
+	for (uint32_t segment = pos->segment; (log = openSegment(segment)); segment++) {
+		fseek(log, offset, SEEK_SET);
+		offset = 0;
+		while ((!lines || printed < lines) && getline(&line, &size, log) > 0) {
+			fputs(line, stdout);
+			printed++;
+		}
+		fclose(log);
+		if (lines && printed >= lines) {break;}
+	}
+	free(line);
+}
+
+void usage (const char *name) {
+	fprintf(stderr, "Usage: %s [-n count] [-a iar [-k nth]] [-l lines] log.txt\n", name);
+	fprintf(stderr, "  -n count  Start at this instruction, from the nearest point in log.txt%s\n", LOGINDEXSUFFIX);
+	fprintf(stderr, "  -a iar    Start at the first (or nth) time this IAR was logged, after -n if given\n");
+	fprintf(stderr, "  -k nth    Which occurrence of -a\n");
+	fprintf(stderr, "  -l lines  Lines to print (default: 40, 0 is to the end)\n");
+	fprintf(stderr, "Exact instruction counts need LOGINSTR, otherwise -n starts at the\n");
+	fprintf(stderr, "first message logged after the nearest index point.\n");
+}
+
+int main (int argc, char *argv[]) {
+	int opt;
+	while ((opt = getopt(argc, argv, "n:a:k:l:")) != -1) {
+		switch (opt) {
+			case 'n':
+				target = strtoull(optarg, NULL, 0);
+				haveCount = 1;
+				break;
+			case 'a':
+				iar = strtoul(optarg, NULL, 16);
+				haveIAR = 1;
+				break;
+			case 'k':
+				nth = strtoull(optarg, NULL, 0);
+				break;
+			case 'l':
+				lines = strtoull(optarg, NULL, 0);
+				break;
+			default:
+				usage(argv[0]);
+				return 1;
+		}
+	}
+	if (optind >= argc || !nth) {
+		usage(argv[0]);
+		return 1;
+	}
+	logName = argv[optind];
+
+	struct logPos pos;
+	if (seekIndex(&pos, target) && haveCount) {
+		fprintf(stderr, "Error opening %s%s\n", logName, LOGINDEXSUFFIX);
+		return 1;
+	}
+	struct logPos start = pos;
+	if ((haveCount || haveIAR) && findLine(&pos)) {
+		if (haveIAR) {
+			fprintf(stderr, "IAR 0x%08X not logged %llu times\n", iar, (unsigned long long)nth);
+			return 1;
+		}
+		if (pos.count != start.count) {
+			fprintf(stderr, "Log ends at instruction %llu\n", (unsigned long long)pos.count);
+			return 1;
+		}
+		// No instructions in the log, the index point is as close as it gets
+		pos = start;
+	}
+	if (pos.counted) {
+		printf("# instruction %llu, %s segment %u offset %llu\n", (unsigned long long)pos.count, logName, pos.segment, (unsigned long long)pos.offset);
+	}
+	printFrom(&pos);
+	return 0;
+}
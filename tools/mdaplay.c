@@ -0,0 +1,178 @@
+// MDA Screen Recording Player
+// Build: cc -o mdaplay mdaplay.c
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../screenrec.h"
+
+#define MAXCOLS 255
+#define MAXROWS 255
+
+FILE *recfile;
+int cols, rows;
+uint8_t screen[MAXROWS][MAXCOLS*2];
+uint8_t saved[MAXROWS][MAXCOLS*2];
+uint64_t instCount = 0;
+int cursor = SCREENREC_NOCURSOR;
+
+int readVarint (uint64_t* value) {
+	int shift = 0;
+	int c;
+	*value = 0;
+	do {
+		c = fgetc(recfile);
+		if (c == EOF || shift > 63) {return -1;}
+		*value |= (uint64_t)(c & 0x7F) << shift;
+		shift += 7;
+	} while (c & 0x80);
+	return 0;
+}
+
+// Apply the next frame to screen, returns -1 at the end of the recording
+int readFrame (void) {
+	uint64_t delta;
+	uint8_t hdr[3];
+	if (readVarint(&delta)) {return -1;}
+	if (fread(hdr, 1, 3, recfile) != 3) {return -1;}
+	instCount += delta;
+	cursor = hdr[0] | (hdr[1] << 8);
+	for (int i=0; i < hdr[2]; i++) {
+		uint8_t span[3];
+		if (fread(span, 1, 3, recfile) != 3) {return -1;}
+		if (span[0] >= rows || (span[1] + span[2]) > cols) {
+			fprintf(stderr, "Corrupt span at inst %llu\n", (unsigned long long)instCount);
+			return -1;
+		}
+		if (fread(&screen[span[0]][span[1]*2], 2, span[2], recfile) != span[2]) {return -1;}
+	}
+	return 0;
+}
+
+// Same text rendering as the headless screen dumps so the output can be diffed
+void printScreen (FILE* out) {
+	char line[MAXCOLS+1];
+	fprintf(out, "--- MDA screen at inst %llu ---\n", (unsigned long long)instCount);
+	for (int row=0; row < rows; row++) {
+		int len = 0;
+		for (int col=0; col < cols; col++) {
+			uint8_t glyph = screen[row][col*2];
+			uint8_t attr = screen[row][(col*2)+1];
+			if ((attr & 0x77) == 0x00 || glyph == 0x00) {
+				line[col] = ' ';
+			} else if (glyph < 0x20 || glyph > 0x7E) {
+				line[col] = '.';
+			} else {
+				line[col] = glyph;
+			}
+			if (line[col] != ' ') {len = col + 1;}
+		}
+		line[len] = '\0';
+		fprintf(out, "%s\n", line);
+	}
+}
+
+// Redraw in place on an ANSI terminal, reverse video and cursor shown
+void playScreen (void) {
+	printf("\033[H");
+	for (int row=0; row < rows; row++) {
+		for (int col=0; col < cols; col++) {
+			uint8_t glyph = screen[row][col*2];
+			uint8_t attr = screen[row][(col*2)+1];
+			int reverse = ((attr & 0x77) == 0x70) || (cursor == (row * cols) + col);
+			if ((attr & 0x77) == 0x00 || glyph < 0x20 || glyph > 0x7E) {glyph = ' ';}
+			printf(reverse ? "\033[7m%c\033[0m" : "%c", glyph);
+		}
+		printf("\033[K\n");
+	}
+	printf("inst %llu\033[K\n", (unsigned long long)instCount);
+	fflush(stdout);
+}
+
+void usage (const char *name) {
+	fprintf(stderr, "Usage: %s [-n inst | -p [-s speed]] screen.rec\n", name);
+	fprintf(stderr, "  (none)  Print every recorded screen as text\n");
+	fprintf(stderr, "  -n      Print only the screen as it was at this instruction count\n");
+	fprintf(stderr, "  -p      Play back on the terminal in emulated time\n");
+	fprintf(stderr, "  -s      Playback speed multiplier (default: 1)\n");
+}
+
+int main (int argc, char *argv[]) {
+	int extract = 0;
+	uint64_t extractInst = 0;
+	int play = 0;
+	double speed = 1.0;
+	int opt;
+	while ((opt = getopt(argc, argv, "n:ps:")) != -1) {
+		switch (opt) {
+			case 'n':
+				extract = 1;
+				extractInst = strtoull(optarg, NULL, 0);
+				break;
+			case 'p':
+				play = 1;
+				break;
+			case 's':
+				speed = atof(optarg);
+				if (speed <= 0) {speed = 1.0;}
+				break;
+			default:
+				usage(argv[0]);
+				return 1;
+		}
+	}
+	if (optind >= argc) {
+		usage(argv[0]);
+		return 1;
+	}
+	recfile = fopen(argv[optind], "rb");
+	if (!recfile) {
+		fprintf(stderr, "Error opening %s\n", argv[optind]);
+		return 1;
+	}
+	char magic[SCREENREC_MAGICLEN];
+	if (fread(magic, 1, SCREENREC_MAGICLEN, recfile) != SCREENREC_MAGICLEN || memcmp(magic, SCREENREC_MAGIC, SCREENREC_MAGICLEN)) {
+		fprintf(stderr, "%s is not a screen recording\n", argv[optind]);
+		return 1;
+	}
+	cols = fgetc(recfile);
+	rows = fgetc(recfile);
+	if (cols <= 0 || rows <= 0) {
+		fprintf(stderr, "Bad screen size in %s\n", argv[optind]);
+		return 1;
+	}
+
+	if (play) {printf("\033[2J");}
+	uint64_t prevInst = 0;
+	while (1) {
+		if (extract) {
+			// Frame may be past the one we want, keep what came before it
+			memcpy(saved, screen, sizeof(screen));
+			prevInst = instCount;
+		}
+		if (readFrame()) {break;}
+		if (extract) {
+			if (instCount > extractInst) {
+				memcpy(screen, saved, sizeof(screen));
+				instCount = prevInst;
+				break;
+			}
+		} else if (play) {
+			uint64_t ns = ((instCount - prevInst) * NS_PER_INST) / speed;
+			struct timespec wait = {ns / 1000000000, ns % 1000000000};
+			nanosleep(&wait, NULL);
+			prevInst = instCount;
+			playScreen();
+		} else {
+			printScreen(stdout);
+		}
+	}
+	if (extract) {
+		printScreen(stdout);
+	}
+	fclose(recfile);
+	return 0;
+}
@@ -0,0 +1,328 @@
+// Binary Execution Trace Decoder
+// Build: cc -o rttrace rttrace.c ../disasm.c
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../trace.h"
+#include "../disasm.h"
+#include "../logfac.h"
+
+#define SCR_IAR 13
+#define STEPTEXTMAX 8192
+
+struct traceStep {
+	uint64_t instCount;
+	uint32_t iar;
+	uint32_t inst;
+	uint8_t flags;
+	uint32_t gprMask;
+	uint32_t scrMask;
+	uint32_t accCount;
+	uint8_t accKind[TRACEACCMAX];
+	uint32_t accAddr[TRACEACCMAX];
+	uint32_t accData[TRACEACCMAX];
+};
+
+const char *widthNames[] = {"B", "H", "W", "TS", "I", "?", "?", "?"};
+const char *pioNames[] = {"", " REAL", " TRANS", " PIO"};
+
+FILE *tracefile;
+uint32_t GPR[16];
+uint32_t SCR[16];
+uint32_t nextIAR = 0;
+uint32_t accAddr = 0;
+
+// Filters, all must match
+uint32_t iarLo = 0, iarHi = UINT32_MAX;
+uint32_t accLo = 0, accHi = UINT32_MAX;
+int accFilter = 0;
+int opFilter = -1;
+int ioOnly = 0;
+uint64_t countLo = 0, countHi = UINT64_MAX;
+const char *grepText = NULL;
+uint64_t nthMatch = 0;	// Only this match, then stop
+
+int readVarint (uint32_t* value) {
+	int shift = 0;
+	int c;
+	*value = 0;
+	do {
+		c = fgetc(tracefile);
+		if (c == EOF || shift > 28) {return -1;}
+		*value |= (uint32_t)(c & 0x7F) << shift;
+		shift += 7;
+	} while (c & 0x80);
+	return 0;
+}
+
+int32_t unzigzag (uint32_t value) {
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+int readRegs (uint32_t* regs, uint32_t* mask) {
+	uint32_t delta;
+	if (readVarint(mask)) {return -1;}
+	for (int i=0; i < 16; i++) {
+		if (*mask & (1 << i)) {
+			if (readVarint(&delta)) {return -1;}
+			regs[i] += unzigzag(delta);
+		}
+	}
+	return 0;
+}
+
+// Returns -1 at the end of the trace
+int readStep (struct traceStep* step) {
+	int c = fgetc(tracefile);
+	if (c == EOF) {return -1;}
+	step->flags = c;
+	if (step->flags & TRACE_Reset) {
+		memset(GPR, 0, sizeof(GPR));
+		memset(SCR, 0, sizeof(SCR));
+		nextIAR = 0;
+		accAddr = 0;
+	}
+	step->iar = nextIAR;
+	if (step->flags & TRACE_Jump) {
+		uint32_t delta;
+		if (readVarint(&delta)) {return -1;}
+		step->iar = nextIAR + unzigzag(delta);
+	}
+	uint8_t word[4] = {0, 0, 0, 0};
+	int len = (step->flags & TRACE_Long) ? 4 : 2;
+	if (fread(word, 1, len, tracefile) != (size_t)len) {return -1;}
+	step->inst = (word[0] << 24) | (word[1] << 16) | (word[2] << 8) | word[3];
+	step->gprMask = 0;
+	step->scrMask = 0;
+	step->accCount = 0;
+	if ((step->flags & TRACE_GPRs) && readRegs(GPR, &step->gprMask)) {return -1;}
+	if ((step->flags & TRACE_SCRs) && readRegs(SCR, &step->scrMask)) {return -1;}
+	if (step->flags & TRACE_Accesses) {
+		if (readVarint(&step->accCount) || step->accCount > TRACEACCMAX) {return -1;}
+		for (uint32_t i=0; i < step->accCount; i++) {
+			uint32_t delta;
+			c = fgetc(tracefile);
+			if (c == EOF || readVarint(&delta) || readVarint(&step->accData[i])) {return -1;}
+			step->accKind[i] = c;
+			accAddr += unzigzag(delta);
+			step->accAddr[i] = accAddr;
+		}
+	}
+	nextIAR = step->iar + len;
+	SCR[SCR_IAR] = step->iar;
+	return 0;
+}
+
+int isIOAccess (struct traceStep* step, uint32_t i) {
+	return ((step->accKind[i] & TRACEACC_PIO) >> 4) == PIO_PIO || step->accAddr[i] >= 0xF0000000;
+}
+
+int stepMatches (struct traceStep* step) {
+	if (step->instCount < countLo || step->instCount > countHi) {return 0;}
+	if (step->iar < iarLo || step->iar > iarHi) {return 0;}
+	if (opFilter >= 0 && (step->inst >> 24) != (uint32_t)opFilter) {return 0;}
+	if (accFilter || ioOnly) {
+		int found = 0;
+		for (uint32_t i=0; i < step->accCount && !found; i++) {
+			if (accFilter && (step->accAddr[i] < accLo || step->accAddr[i] > accHi)) {continue;}
+			if (ioOnly && !isIOAccess(step, i)) {continue;}
+			found = 1;
+		}
+		if (!found) {return 0;}
+	}
+	return 1;
+}
+
+void formatInst (char* buf, int size, uint32_t iar, uint32_t inst) {
+	char text[DISASMMAX];
+	if (disasm(inst, text, sizeof(text)) == 4) {
+		snprintf(buf, size, "INSTR: 0x%08X: 0x%08X	%s", iar, inst, text);
+	} else {
+		snprintf(buf, size, "INSTR: 0x%08X: 0x%04X		%s", iar, inst >> 16, text);
+	}
+}
+
+// Same shape as the LOGINSTR text log, changes and accesses indented below
+int formatText (char* buf, int size, struct traceStep* step) {
+	char line[128];
+	int len = 0;
+	formatInst(line, sizeof(line), step->iar, step->inst);
+	len += snprintf(buf + len, size - len, "%s\n", line);
+	for (int i=0; i < 16; i++) {
+		if (step->gprMask & (1 << i)) {len += snprintf(buf + len, size - len, "			GPR%d = 0x%08X\n", i, GPR[i]);}
+	}
+	for (int i=0; i < 16; i++) {
+		if (step->scrMask & (1 << i)) {len += snprintf(buf + len, size - len, "			SCR%d = 0x%08X\n", i, SCR[i]);}
+	}
+	for (uint32_t i=0; i < step->accCount && len < size; i++) {
+		uint8_t kind = step->accKind[i];
+		uint8_t width = (kind & TRACEACC_Width) >> 1;
+		if (width == WIDTH_INST) {
+			formatInst(line, sizeof(line), step->accAddr[i], step->accData[i]);
+			len += snprintf(buf + len, size - len, " SUB%s\n", line);
+			continue;
+		}
+		len += snprintf(buf + len, size - len, "			%s %s 0x%08X: 0x%08X%s%s\n", (kind & TRACEACC_Store) ? "STORE" : "LOAD ",
+			widthNames[width & 7], step->accAddr[i], step->accData[i], pioNames[(kind & TRACEACC_PIO) >> 4],
+			(kind & TRACEACC_Exception) ? " EXCEPTION" : "");
+	}
+	if (len >= size) {len = size - 1;}
+	return len;
+}
+
+int formatCSV (char* buf, int size, struct traceStep* step) {
+	char text[DISASMMAX];
+	int len = 0;
+	if (disasm(step->inst, text, sizeof(text)) == 4) {
+		len += snprintf(buf + len, size - len, "%llu,0x%08X,0x%08X,\"%s\",\"", (unsigned long long)step->instCount, step->iar, step->inst, text);
+	} else {
+		len += snprintf(buf + len, size - len, "%llu,0x%08X,0x%04X,\"%s\",\"", (unsigned long long)step->instCount, step->iar, step->inst >> 16, text);
+	}
+	for (int i=0; i < 16; i++) {
+		if (step->gprMask & (1 << i)) {len += snprintf(buf + len, size - len, "GPR%d=0x%08X ", i, GPR[i]);}
+	}
+	for (int i=0; i < 16; i++) {
+		if (step->scrMask & (1 << i)) {len += snprintf(buf + len, size - len, "SCR%d=0x%08X ", i, SCR[i]);}
+	}
+	len += snprintf(buf + len, size - len, "\",\"");
+	for (uint32_t i=0; i < step->accCount && len < size; i++) {
+		uint8_t kind = step->accKind[i];
+		len += snprintf(buf + len, size - len, "%s%s:%s:0x%08X:0x%08X", i ? " " : "", (kind & TRACEACC_Store) ? "S" : "L",
+			widthNames[((kind & TRACEACC_Width) >> 1) & 7], step->accAddr[i], step->accData[i]);
+	}
+	len += snprintf(buf + len, size - len, "\"\n");
+	if (len >= size) {len = size - 1;}
+	return len;
+}
+
+int parseRange (const char* arg, uint32_t* lo, uint32_t* hi) {
+	char *end;
+	*lo = strtoul(arg, &end, 0);
+	*hi = *lo;
+	if (*end == '-') {*hi = strtoul(end + 1, &end, 0);}
+	return *end != '\0';
+}
+
+// Jump to the last index point at or before count, returns its count or the
+// current one if there's no index or nothing earlier in it
+uint64_t seekIndex (const char* file, uint64_t target, uint64_t count) {
+	char name[1024];
+	snprintf(name, sizeof(name), "%s%s", file, LOGINDEXSUFFIX);
+	FILE *index = fopen(name, "r");
+	if (!index) {return count;}
+	char line[128];
+	unsigned long long indexCount, offset, bestOffset = 0;
+	unsigned segment;
+	uint64_t best = count;
+	while (fgets(line, sizeof(line), index)) {
+		if (sscanf(line, "%llu %u %llu", &indexCount, &segment, &offset) != 3) {continue;}
+		if (indexCount > target) {break;}
+		if (indexCount >= best) {
+			best = indexCount;
+			bestOffset = offset;
+		}
+	}
+	fclose(index);
+	if (best != count && !fseek(tracefile, bestOffset, SEEK_SET)) {
+		// Index points are reset records, the state zeroing happens in readStep()
+		return best;
+	}
+	return count;
+}
+
+void usage (const char *name) {
+	fprintf(stderr, "Usage: %s [-c] [filters] trace.bin\n", name);
+	fprintf(stderr, "  -c          CSV, one row per instruction\n");
+	fprintf(stderr, "  -n lo[-hi]  Instruction count range\n");
+	fprintf(stderr, "  -a lo[-hi]  IAR range\n");
+	fprintf(stderr, "  -m lo[-hi]  Only instructions accessing this address range\n");
+	fprintf(stderr, "  -o op       Only this first opcode byte\n");
+	fprintf(stderr, "  -I          Only instructions doing I/O\n");
+	fprintf(stderr, "  -g text     Only instructions whose text output contains this\n");
+	fprintf(stderr, "  -k nth      Only the nth match, then stop (e.g. -a 0x8021B2 -k 3)\n");
+	fprintf(stderr, "With -n, decoding starts at the nearest point in trace.bin%s\n", LOGINDEXSUFFIX);
+}
+
+int main (int argc, char *argv[]) {
+	int csv = 0;
+	int opt;
+	while ((opt = getopt(argc, argv, "cn:a:m:o:Ig:k:")) != -1) {
+		switch (opt) {
+			case 'c':
+				csv = 1;
+				break;
+			case 'n': {
+				char *end;
+				countLo = strtoull(optarg, &end, 0);
+				countHi = (*end == '-') ? strtoull(end + 1, NULL, 0) : countLo;
+				break;
+			}
+			case 'a':
+				if (parseRange(optarg, &iarLo, &iarHi)) {usage(argv[0]); return 1;}
+				break;
+			case 'm':
+				if (parseRange(optarg, &accLo, &accHi)) {usage(argv[0]); return 1;}
+				accFilter = 1;
+				break;
+			case 'o':
+				opFilter = strtoul(optarg, NULL, 16) & 0xFF;
+				break;
+			case 'I':
+				ioOnly = 1;
+				break;
+			case 'g':
+				grepText = optarg;
+				break;
+			case 'k':
+				nthMatch = strtoull(optarg, NULL, 0);
+				break;
+			default:
+				usage(argv[0]);
+				return 1;
+		}
+	}
+	if (optind >= argc) {
+		usage(argv[0]);
+		return 1;
+	}
+	tracefile = fopen(argv[optind], "rb");
+	if (!tracefile) {
+		fprintf(stderr, "Error opening %s\n", argv[optind]);
+		return 1;
+	}
+	char magic[TRACE_MAGICLEN];
+	if (fread(magic, 1, TRACE_MAGICLEN, tracefile) != TRACE_MAGICLEN || (memcmp(magic, TRACE_MAGIC, TRACE_MAGICLEN) && memcmp(magic, TRACE_MAGIC1, TRACE_MAGICLEN))) {
+		fprintf(stderr, "%s is not an execution trace\n", argv[optind]);
+		return 1;
+	}
+	// Instruction count of the first step, wider than readVarint() takes
+	uint64_t count = 0;
+	int shift = 0, c;
+	do {
+		c = fgetc(tracefile);
+		if (c == EOF) {return 1;}
+		count |= (uint64_t)(c & 0x7F) << shift;
+		shift += 7;
+	} while (c & 0x80);
+	if (countLo > count) {count = seekIndex(argv[optind], countLo, count);}
+
+	if (csv) {printf("inst,iar,word,disasm,registers,accesses\n");}
+	static char buf[STEPTEXTMAX];
+	struct traceStep step;
+	uint64_t matches = 0;
+	while (!readStep(&step)) {
+		step.instCount = count++;
+		if (step.instCount > countHi) {break;}
+		if (!stepMatches(&step)) {continue;}
+		int len = csv ? formatCSV(buf, sizeof(buf), &step) : formatText(buf, sizeof(buf), &step);
+		if (grepText && !strstr(buf, grepText)) {continue;}
+		if (nthMatch && ++matches < nthMatch) {continue;}
+		fwrite(buf, 1, len, stdout);
+		if (nthMatch) {break;}
+	}
+	fclose(tracefile);
+	return 0;
+}
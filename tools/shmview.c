@@ -0,0 +1,101 @@
+// Shared Memory Screen Viewer
+// Build: cc -o shmview shmview.c (add -lrt on older glibc)
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "../shmexport.h"
+
+#define COLS 80
+#define ROWS 25
+
+const char *stateNames[] = {"RUN", "WAIT", "HALT", "STOPPED"};
+
+// Consistent copy of the segment, retrying while the emulator writes it
+void readExport (struct shmExport* shm, struct shmExport* copy) {
+	uint32_t seq;
+	do {
+		seq = atomic_load_explicit(&shm->seq, memory_order_acquire);
+		if (seq & 1) {continue;}
+		memcpy(copy, shm, sizeof(*copy));
+		atomic_thread_fence(memory_order_acquire);
+	} while ((seq & 1) || seq != atomic_load_explicit(&shm->seq, memory_order_relaxed));
+}
+
+void printScreen (struct shmExport* copy, int ansi) {
+	char line[COLS+1];
+	char disp[3] = "  ";
+	if (copy->dispCode != 0xFF) {snprintf(disp, sizeof(disp), "%02X", copy->dispCode);}
+	if (ansi) {printf("\033[H");}
+	printf("pid %u  %-7s  IAR 0x%08X  FP %s  inst %llu%s\n", copy->pid, stateNames[copy->state & 3], copy->IAR, disp,
+		(unsigned long long)copy->instCount, ansi ? "\033[K" : "");
+	for (int row=0; row < ROWS; row++) {
+		for (int col=0; col < COLS; col++) {
+			uint16_t cell = (copy->startAddr + (row * COLS) + col) & ((SHMEXPORT_VIDEOSIZE >> 1) - 1);
+			uint8_t glyph = copy->videoMem[cell << 1];
+			uint8_t attr = copy->videoMem[(cell << 1) + 1];
+			if ((attr & 0x77) == 0x00 || glyph < 0x20 || glyph > 0x7E) {glyph = ' ';}
+			line[col] = glyph;
+		}
+		line[COLS] = '\0';
+		printf("%s%s\n", line, ansi ? "\033[K" : "");
+	}
+	fflush(stdout);
+}
+
+int main (int argc, char *argv[]) {
+	int once = 0;
+	int opt;
+	while ((opt = getopt(argc, argv, "1")) != -1) {
+		switch (opt) {
+			case '1':
+				once = 1;
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-1] shmname\n  -1  Print the screen once and exit\n", argv[0]);
+				return 1;
+		}
+	}
+	if (optind >= argc) {
+		fprintf(stderr, "Usage: %s [-1] shmname\n", argv[0]);
+		return 1;
+	}
+	char name[256];
+	snprintf(name, sizeof(name), "%s%s", (argv[optind][0] == '/') ? "" : "/", argv[optind]);
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0) {
+		fprintf(stderr, "Error opening shared memory %s\n", name);
+		return 1;
+	}
+	struct shmExport *shm = mmap(NULL, sizeof(struct shmExport), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (shm == MAP_FAILED || memcmp(shm->magic, SHMEXPORT_MAGIC, SHMEXPORT_MAGICLEN)) {
+		fprintf(stderr, "%s is not an emulator export\n", name);
+		return 1;
+	}
+
+	struct shmExport copy;
+	uint32_t prevSeq = 0;
+	if (!once) {printf("\033[2J");}
+	while (1) {
+		readExport(shm, &copy);
+		if (once) {
+			printScreen(&copy, 0);
+			break;
+		}
+		if (copy.seq != prevSeq) {
+			prevSeq = copy.seq;
+			printScreen(&copy, 1);
+		}
+		if (copy.state == SHMSTATE_STOPPED) {break;}
+		struct timespec idle = {0, 50000000};
+		nanosleep(&idle, NULL);
+	}
+	munmap(shm, sizeof(struct shmExport));
+	return 0;
+}
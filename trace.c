@@ -0,0 +1,184 @@
+// Binary Execution Trace
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "trace.h"
+#include "romp.h"
+#include "disasm.h"
+#include "logfac.h"
+#include "varint.h"
+
+#define SCR_IAR 13
+
+struct traceAccessEntry {
+	uint8_t kind;
+	uint32_t addr;
+	uint32_t data;
+};
+
+int traceOn = 0;
+FILE *tracefile = NULL;
+FILE *traceIndexFile = NULL;
+uint8_t traceBuf[TRACEBUFSIZE];
+uint32_t traceLen;
+uint64_t traceWritten;	// File offset of traceBuf[0]
+uint64_t traceNextIndex;
+uint32_t *traceGPRptr;
+uint32_t *traceSCRptr;
+// State as of the last record
+uint32_t traceGPR[16];
+uint32_t traceSCR[16];
+uint32_t traceNextIAR;
+uint32_t traceAccAddr;
+// Current record
+int traceInStep = 0;
+uint32_t traceIAR;
+uint32_t traceInst;
+struct traceAccessEntry traceAcc[TRACEACCMAX];
+uint32_t traceAccCount;
+uint64_t traceAccDropped;
+
+void traceFlush (void) {
+	fwrite(traceBuf, 1, traceLen, tracefile);
+	traceWritten += traceLen;
+	traceLen = 0;
+}
+
+static inline void tracePutByte (uint8_t byte) {
+	traceBuf[traceLen++] = byte;
+}
+
+static inline void tracePutVarint (uint32_t value) {
+	traceLen += varintPut(&traceBuf[traceLen], value);
+}
+
+static inline uint32_t zigzag (int32_t value) {
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int traceStart (const char *file, uint32_t* GPRptr, uint32_t* SCRptr) {
+	tracefile = fopen(file, "wb");
+	if (!tracefile) {
+		printf("Error opening trace file %s\n", file);
+		return -1;
+	}
+	traceGPRptr = GPRptr;
+	traceSCRptr = SCRptr;
+	traceAccCount = 0;
+	traceAccDropped = 0;
+	char name[256];
+	snprintf(name, sizeof(name), "%s%s", file, LOGINDEXSUFFIX);
+	traceIndexFile = fopen(name, "w");
+	if (!traceIndexFile) {
+		printf("Error opening trace index %s\n", name);
+		fclose(tracefile);
+		return -1;
+	}
+	fprintf(traceIndexFile, "# instruction count, segment (always 0), offset\n");
+	traceLen = 0;
+	traceNextIndex = 0;
+	fwrite(TRACE_MAGIC, 1, TRACE_MAGICLEN, tracefile);
+	// Decoder state starts at zero, so the first record carries everything
+	memset(traceGPR, 0, sizeof(traceGPR));
+	memset(traceSCR, 0, sizeof(traceSCR));
+	traceNextIAR = 0;
+	traceAccAddr = 0;
+	traceWritten = TRACE_MAGICLEN + varintWrite(tracefile, getInstCount());
+	traceOn = 1;
+	return 0;
+}
+
+void traceStop (void) {
+	if (!traceOn) {return;}
+	traceOn = 0;
+	traceFlush();
+	fclose(tracefile);
+	tracefile = NULL;
+	fclose(traceIndexFile);
+	traceIndexFile = NULL;
+	if (traceAccDropped) {
+		printf("Trace dropped %llu accesses past %d per instruction\n", (unsigned long long)traceAccDropped, TRACEACCMAX);
+	}
+}
+
+// After mmuCycle(), so loads have their data. The instruction fetch itself
+// isn't recorded, the word is in the record, but execute form subjects are.
+void traceAccess (struct procBusStruct* bus, uint32_t addr, uint8_t pio) {
+	if (bus->width == WIDTH_INST && !traceInStep) {return;}
+	if (traceAccCount >= TRACEACCMAX) {
+		traceAccDropped++;
+		return;
+	}
+	struct traceAccessEntry *entry = &traceAcc[traceAccCount++];
+	entry->kind = (bus->rw ? TRACEACC_Store : 0) | (bus->width << 1) | (pio << 4) | ((bus->flags & FLAGS_Exception) ? TRACEACC_Exception : 0);
+	entry->addr = addr;
+	entry->data = bus->data;
+}
+
+void traceBegin (uint32_t iar, uint32_t inst) {
+	traceIAR = iar;
+	traceInst = inst;
+	traceInStep = 1;
+}
+
+void putRegChanges (uint32_t* regs, uint32_t* prev, uint32_t mask) {
+	tracePutVarint(mask);
+	for (int i=0; i < 16; i++) {
+		if (mask & (1 << i)) {
+			tracePutVarint(zigzag(regs[i] - prev[i]));
+			prev[i] = regs[i];
+		}
+	}
+}
+
+void traceEnd (void) {
+	traceInStep = 0;
+	// Worst case record is well under 2K
+	if (traceLen > (TRACEBUFSIZE - 2048)) {traceFlush();}
+
+	uint8_t reset = 0;
+	uint64_t count = getInstCount();
+	if (count >= traceNextIndex) {
+		// Start over from zero state, decoding can begin at this record
+		memset(traceGPR, 0, sizeof(traceGPR));
+		memset(traceSCR, 0, sizeof(traceSCR));
+		traceNextIAR = 0;
+		traceAccAddr = 0;
+		reset = TRACE_Reset;
+		fprintf(traceIndexFile, "%llu 0 %llu\n", (unsigned long long)count, (unsigned long long)(traceWritten + traceLen));
+		traceNextIndex = count - (count % TRACEINDEXINSTS) + TRACEINDEXINSTS;
+	}
+
+	uint32_t gprMask = 0;
+	uint32_t scrMask = 0;
+	for (int i=0; i < 16; i++) {
+		if (traceGPRptr[i] != traceGPR[i]) {gprMask |= 1 << i;}
+		if (i != SCR_IAR && traceSCRptr[i] != traceSCR[i]) {scrMask |= 1 << i;}
+	}
+	int len = instLength(traceInst);
+	uint8_t flags = reset | (traceIAR != traceNextIAR ? TRACE_Jump : 0) | (len == 4 ? TRACE_Long : 0) |
+		(gprMask ? TRACE_GPRs : 0) | (scrMask ? TRACE_SCRs : 0) | (traceAccCount ? TRACE_Accesses : 0);
+
+	tracePutByte(flags);
+	if (flags & TRACE_Jump) {tracePutVarint(zigzag(traceIAR - traceNextIAR));}
+	tracePutByte(traceInst >> 24);
+	tracePutByte(traceInst >> 16);
+	if (len == 4) {
+		tracePutByte(traceInst >> 8);
+		tracePutByte(traceInst);
+	}
+	if (gprMask) {putRegChanges(traceGPRptr, traceGPR, gprMask);}
+	if (scrMask) {putRegChanges(traceSCRptr, traceSCR, scrMask);}
+	if (traceAccCount) {
+		tracePutVarint(traceAccCount);
+		for (uint32_t i=0; i < traceAccCount; i++) {
+			tracePutByte(traceAcc[i].kind);
+			tracePutVarint(zigzag(traceAcc[i].addr - traceAccAddr));
+			tracePutVarint(traceAcc[i].data);
+			traceAccAddr = traceAcc[i].addr;
+		}
+		traceAccCount = 0;
+	}
+	traceNextIAR = traceIAR + len;
+}
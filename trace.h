@@ -0,0 +1,48 @@
+// Binary Execution Trace
+#ifndef _TRACE
+#define _TRACE
+#include <stdint.h>
+#include "defs.h"
+
+// File: "RTTRACE2", then the instruction count of the first step (varint),
+// then one record per executed instruction:
+//  flags (u8, TRACE_*), IAR as a zigzag varint delta from the next sequential
+//  address (if TRACE_Jump), instruction word (2 or 4 bytes, big endian),
+//  GPR/SCR changes as a varint bit mask then zigzag varint deltas per set bit,
+//  accesses as a varint count then per access: kind (u8, TRACEACC_*), address
+//  as a zigzag varint delta from the previous access, data (varint).
+// Register changes and accesses include anything that happened since the last
+// record, like an interrupt being taken before this instruction.
+// Every TRACEINDEXINSTS instructions a record is written as if it were the
+// first (TRACE_Reset) and indexed in trace.bin.idx, same format as the log's
+// index (see logfac.h), so decoding can start there. RTTRACE1 files are the
+// same without resets.
+#define TRACE_MAGIC			"RTTRACE2"
+#define TRACE_MAGIC1		"RTTRACE1"
+#define TRACE_MAGICLEN	8
+#define TRACEINDEXINSTS	100000
+
+#define TRACE_Jump			0x01	// IAR is not the previous IAR + length
+#define TRACE_Long			0x02	// 4 byte instruction
+#define TRACE_GPRs			0x04
+#define TRACE_SCRs			0x08	// IAR is never included, it's above
+#define TRACE_Accesses	0x10
+#define TRACE_Reset			0x20	// Decoder state is zeroed before this record
+
+#define TRACEACC_Store			0x01
+#define TRACEACC_Width			0x0E	// WIDTH_* << 1
+#define TRACEACC_PIO				0x30	// PIO_* << 4, 0 is the default for the mode
+#define TRACEACC_Exception	0x40
+
+#define TRACEACCMAX	64		// Per record, more than this are dropped and counted
+#define TRACEBUFSIZE	(1024*1024)
+
+extern int traceOn;
+
+int traceStart (const char *file, uint32_t* GPRptr, uint32_t* SCRptr);
+void traceStop (void);
+void traceAccess (struct procBusStruct* bus, uint32_t addr, uint8_t pio);
+void traceBegin (uint32_t iar, uint32_t inst);
+void traceEnd (void);
+
+#endif
@@ -0,0 +1,282 @@
+// Conditional Log Triggers
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "triggers.h"
+#include "logfac.h"
+#include "flightrec.h"
+
+struct trigRule {
+	uint8_t type;
+	uint8_t action;
+	uint64_t lo;
+	uint64_t hi;
+	unsigned int mask;
+	uint8_t inside;	// Condition held last time it was checked
+	uint8_t done;	// inst rules only fire once
+	uint64_t closeAt;	// Instruction count the window closes at
+	char spec[64];
+};
+
+struct trigName {
+	const char *name;
+	uint32_t lo;
+	uint32_t hi;
+};
+
+const struct trigName trigMasks[] = {
+	{"all", LOGALL, 0}, {"instr", LOGINSTR, 0}, {"proc", LOGPROC, 0}, {"mem", LOGMEM, 0},
+	{"mmu", LOGMMU, 0}, {"io", LOGIO, 0}, {"8259", LOG8259, 0}, {"mda", LOGMDA, 0},
+	{"8237", LOG8237, 0}, {"kbadpt", LOGKBADPT, 0}, {"rtc", LOGRTC, 0}, {NULL, 0, 0}
+};
+
+// Device I/O ranges as set up in ioinit(), for io=<device>
+const struct trigName trigDevices[] = {
+	{"kbadpt", 0xF0008400, 0xF0008407}, {"rtc", 0xF0008800, 0xF000883F},
+	{"8237", 0xF0008840, 0xF000887F}, {"8259", 0xF0008880, 0xF00088BF},
+	{"mda", 0xF00003B0, 0xF00003BF}, {NULL, 0, 0}
+};
+
+const char *trigTypes[] = {"iar", "inst", "disp", "mer", "io", NULL};
+const char *trigActions[] = {"start", "stop", "window", "dump", NULL};
+
+struct trigRule trigRules[TRIGMAX];
+int trigCount = 0;
+int trigDefault = 0;	// Only the built in rule is installed
+
+uint8_t trigArmed = 0;
+uint32_t trigIARLo = 1, trigIARHi = 0;
+uint64_t trigNextCount = UINT64_MAX;
+
+void fireRule (struct trigRule* rule) {
+	if (rule->action == TRIGACT_DUMP) {
+		char reason[80];
+		snprintf(reason, sizeof(reason), "Trigger %s", rule->spec);
+		flightrecDump(reason, 1);
+	} else if (rule->action == TRIGACT_STOP) {
+		enlogtypes(getlogtypes() & ~rule->mask);
+	} else {
+		enlogtypes(getlogtypes() | rule->mask);
+	}
+}
+
+void closeRule (struct trigRule* rule) {
+	rule->inside = 0;
+	rule->closeAt = UINT64_MAX;
+	enlogtypes(getlogtypes() & ~rule->mask);
+}
+
+// Recompute what the inline hooks compare against after any rule changes
+void rearm (void) {
+	trigArmed = 0;
+	trigIARLo = UINT32_MAX;
+	trigIARHi = 0;
+	trigNextCount = UINT64_MAX;
+	for (int i=0; i < trigCount; i++) {
+		struct trigRule *rule = &trigRules[i];
+		uint8_t type = rule->type;
+		if (rule->closeAt != UINT64_MAX) {
+			type |= TRIG_INST;
+			if (rule->closeAt < trigNextCount) {trigNextCount = rule->closeAt;}
+		}
+		if (rule->type == TRIG_IAR) {
+			// An open window has to see IAR leave its range
+			uint32_t lo = rule->inside ? 0 : (uint32_t)rule->lo;
+			uint32_t hi = rule->inside ? UINT32_MAX : (uint32_t)rule->hi;
+			if (lo < trigIARLo) {trigIARLo = lo;}
+			if (hi > trigIARHi) {trigIARHi = hi;}
+		} else if (rule->type == TRIG_INST && !rule->done) {
+			if (rule->lo < trigNextCount) {trigNextCount = rule->lo;}
+		}
+		trigArmed |= type;
+	}
+	if (trigNextCount == UINT64_MAX) {trigArmed &= ~TRIG_INST;}
+}
+
+// Matches a name from the list, returns its index or -1
+int lookupName (const char* text, int len, const char** names) {
+	for (int i=0; names[i]; i++) {
+		if (strlen(names[i]) == (size_t)len && !strncmp(text, names[i], len)) {return i;}
+	}
+	return -1;
+}
+
+const struct trigName* lookupEntry (const char* text, int len, const struct trigName* list) {
+	for (; list->name; list++) {
+		if (strlen(list->name) == (size_t)len && !strncmp(text, list->name, len)) {return list;}
+	}
+	return NULL;
+}
+
+int parseMask (const char* text, unsigned int* mask) {
+	*mask = 0;
+	while (*text) {
+		int len = strcspn(text, "|");
+		const struct trigName *entry = lookupEntry(text, len, trigMasks);
+		if (entry) {
+			*mask |= entry->lo;
+		} else {
+			char *end;
+			*mask |= strtoul(text, &end, 0);
+			if (end != text + len) {return -1;}
+		}
+		text += len;
+		if (*text == '|') {text++;}
+	}
+	return 0;
+}
+
+// Number for a rule value, no sign and no more than max
+int parseValue (const char* text, char** end, uint64_t max, uint64_t* value) {
+	if (*text == '-' || *text == '+') {return -1;}
+	errno = 0;
+	*value = strtoull(text, end, 0);
+	return (*end == text || errno == ERANGE || *value > max) ? -1 : 0;
+}
+
+// Built in rule, logging starts before the SysBoard IO regs tests to save log file size
+void triggerinit (void) {
+	trigCount = 0;
+	triggerParse("iar=0x008021B2,start,all");
+	trigDefault = 1;
+}
+
+int triggerParse (const char *spec) {
+	// Rules given on the command line replace the built in one
+	if (trigDefault) {
+		trigDefault = 0;
+		trigCount = 0;
+		rearm();
+	}
+	if (!strcmp(spec, "none")) {return 0;}
+	if (trigCount >= TRIGMAX) {
+		printf("Too many triggers, at most %d\n", TRIGMAX);
+		return -1;
+	}
+	struct trigRule rule = {0, TRIGACT_START, 0, 0, LOGALL, 0, 0, UINT64_MAX, ""};
+	snprintf(rule.spec, sizeof(rule.spec), "%s", spec);
+	const char *eq = strchr(spec, '=');
+	int type = eq ? lookupName(spec, eq - spec, trigTypes) : -1;
+	if (type < 0) {
+		printf("Trigger %s: type must be iar, inst, disp, mer or io\n", spec);
+		return -1;
+	}
+	rule.type = 1 << type;
+
+	const char *value = eq + 1;
+	int len = strcspn(value, ",");
+	const struct trigName *dev = (rule.type == TRIG_IO) ? lookupEntry(value, len, trigDevices) : NULL;
+	if (dev) {
+		rule.lo = dev->lo;
+		rule.hi = dev->hi;
+	} else {
+		// Instruction counts are 64 bits, addresses and the rest 32
+		uint64_t max = (rule.type == TRIG_INST) ? UINT64_MAX : UINT32_MAX;
+		char *end;
+		int bad = parseValue(value, &end, max, &rule.lo);
+		rule.hi = rule.lo;
+		if (!bad && *end == '-') {bad = parseValue(end + 1, &end, max, &rule.hi);}
+		if (bad || end != value + len || rule.hi < rule.lo) {
+			printf("Trigger %s: bad value or range\n", spec);
+			return -1;
+		}
+	}
+
+	const char *action = value + len;
+	if (*action == ',') {
+		action++;
+		len = strcspn(action, ",");
+		int act = lookupName(action, len, trigActions);
+		if (act < 0) {
+			printf("Trigger %s: action must be start, stop, window or dump\n", spec);
+			return -1;
+		}
+		rule.action = act;
+		if (action[len] == ',' && parseMask(action + len + 1, &rule.mask)) {
+			printf("Trigger %s: bad log mask\n", spec);
+			return -1;
+		}
+	}
+	trigRules[trigCount++] = rule;
+	rearm();
+	return 0;
+}
+
+// Window rules get their mask while inside, others fire on entering
+void updateRule (struct trigRule* rule, int match) {
+	if (rule->action == TRIGACT_WINDOW) {
+		if (match && !rule->inside) {
+			rule->inside = 1;
+			fireRule(rule);
+		} else if (!match && rule->inside) {
+			closeRule(rule);
+		}
+	} else if (match && !rule->inside) {
+		rule->inside = 1;
+		fireRule(rule);
+	} else if (!match) {
+		rule->inside = 0;
+	}
+}
+
+void triggerCheck (uint32_t iar) {
+	uint64_t count = getInstCount();
+	for (int i=0; i < trigCount; i++) {
+		struct trigRule *rule = &trigRules[i];
+		if (rule->closeAt != UINT64_MAX) {
+			if (count >= rule->closeAt) {closeRule(rule);}
+		} else if (rule->type == TRIG_IAR) {
+			updateRule(rule, iar >= rule->lo && iar <= rule->hi);
+		} else if (rule->type == TRIG_INST && !rule->done && count >= rule->lo) {
+			rule->done = 1;
+			if (rule->action != TRIGACT_WINDOW) {
+				fireRule(rule);
+			} else if (count <= rule->hi) {
+				fireRule(rule);
+				rule->inside = 1;
+				// One that runs to the last count never closes
+				rule->closeAt = (rule->hi == UINT64_MAX) ? UINT64_MAX : rule->hi + 1;
+			}
+		}
+	}
+	rearm();
+}
+
+void triggerDisp (uint8_t code) {
+	for (int i=0; i < trigCount; i++) {
+		if (trigRules[i].type == TRIG_DISP) {
+			updateRule(&trigRules[i], code >= trigRules[i].lo && code <= trigRules[i].hi);
+		}
+	}
+}
+
+// Single events, a window covers this instruction and any interrupt it raises
+void eventRule (struct trigRule* rule) {
+	if (rule->action == TRIGACT_WINDOW) {
+		if (rule->closeAt == UINT64_MAX) {fireRule(rule);}
+		rule->inside = 1;
+		rule->closeAt = getInstCount() + 2;
+		rearm();
+	} else {
+		fireRule(rule);
+	}
+}
+
+void triggerMER (uint32_t merBit) {
+	for (int i=0; i < trigCount; i++) {
+		if (trigRules[i].type == TRIG_MER && (merBit & trigRules[i].lo)) {
+			eventRule(&trigRules[i]);
+		}
+	}
+}
+
+void triggerIO (uint32_t addr) {
+	for (int i=0; i < trigCount; i++) {
+		if (trigRules[i].type == TRIG_IO && addr >= trigRules[i].lo && addr <= trigRules[i].hi) {
+			eventRule(&trigRules[i]);
+		}
+	}
+}
@@ -0,0 +1,53 @@
+// Conditional Log Triggers
+#ifndef _TRIGGERS
+#define _TRIGGERS
+#include <stdint.h>
+
+// Rule spec: type=lo[-hi],action[,mask[|mask...]]
+//  Types:   iar   IAR about to be fetched is in lo-hi
+//           inst  Instruction count is in lo-hi
+//           disp  Front panel display code changes to a value in lo-hi
+//           mer   Memory exception sets any of the bits in lo
+//           io    I/O access to an address in lo-hi, or a device name
+//  Actions: start  Add mask to the logged types
+//           stop   Remove mask from the logged types
+//           window Log mask only while the condition holds (iar, inst, disp)
+//                  or for the instruction that caused it (mer, io)
+//           dump   Write out the flight recorder, no mask
+//  Masks:   all instr proc mem mmu io 8259 mda 8237 kbadpt rtc, or a number
+// e.g. -T inst=1000000-1200000,window,instr|mmu -T io=kbadpt,start,io
+#define TRIGMAX 16
+
+#define TRIG_IAR		0x01
+#define TRIG_INST		0x02
+#define TRIG_DISP		0x04
+#define TRIG_MER		0x08
+#define TRIG_IO			0x10
+
+#define TRIGACT_START		0
+#define TRIGACT_STOP		1
+#define TRIGACT_WINDOW	2
+#define TRIGACT_DUMP		3
+
+// The hooks below test trigArmed first, nothing else is done with no rules armed
+extern uint8_t trigArmed;
+extern uint32_t trigIARLo, trigIARHi;
+extern uint64_t trigNextCount;
+
+void triggerinit (void);
+int triggerParse (const char *spec);
+void triggerCheck (uint32_t iar);
+void triggerDisp (uint8_t code);
+void triggerMER (uint32_t merBit);
+void triggerIO (uint32_t addr);
+
+uint64_t getInstCount (void);
+
+// Called from the emulation loop before each fetch
+static inline void triggerPoll (uint32_t iar) {
+	if (((trigArmed & TRIG_IAR) && iar >= trigIARLo && iar <= trigIARHi) || ((trigArmed & TRIG_INST) && getInstCount() >= trigNextCount)) {
+		triggerCheck(iar);
+	}
+}
+
+#endif
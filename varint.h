@@ -0,0 +1,29 @@
+// Variable Length Integers
+#ifndef _VARINT
+#define _VARINT
+#include <stdio.h>
+#include <stdint.h>
+
+// 7 bits a byte, low bits first, the top bit set on all but the last byte.
+// Used by the screen recordings and execution traces.
+#define VARINTMAX	10	// Longest encoding of a uint64_t
+
+// Returns the bytes written to buf
+static inline int varintPut (uint8_t* buf, uint64_t value) {
+	int len = 0;
+	while (value >= 0x80) {
+		buf[len++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	buf[len++] = value;
+	return len;
+}
+
+static inline int varintWrite (FILE* fptr, uint64_t value) {
+	uint8_t buf[VARINTMAX];
+	int len = varintPut(buf, value);
+	fwrite(buf, 1, len, fptr);
+	return len;
+}
+
+#endif